@@ -2,6 +2,7 @@
 #include <cmath>
 #include <ctime>
 #include <algorithm>
+#include "datagen.h"
 
 using namespace std;
 
@@ -168,10 +169,11 @@ public:
     }
 };
 
-// 生成随机复数
+// 生成随机复数（固定默认种子，可用环境变量 DATAGEN_SEED 更换）
 Complex randomComplex(double min, double max) {
-    double r = min + (max - min) * rand() / RAND_MAX;
-    double i = min + (max - min) * rand() / RAND_MAX;
+    datagen::Rng& rng = datagen::threadRng();
+    double r = rng.uniform(min, max);
+    double i = rng.uniform(min, max);
     return Complex(r, i);
 }
 
@@ -275,7 +277,6 @@ void testSortingEfficiency() {
     Vector<Complex> original;
     
     // 生成随机复数向量
-    srand(time(0));
     for (int i = 0; i < size; ++i) {
         original.push_back(randomComplex(0, 100));
     }
@@ -343,8 +344,6 @@ void testSortingEfficiency() {
 }
 
 int main() {
-    srand(time(0));  // 初始化随机数生成器
-
     // 1. 测试无序向量的基本操作
     cout << "=== 测试无序向量操作 ===" << endl;
     Vector<Complex> vec;
@@ -361,7 +360,7 @@ int main() {
     // 置乱操作
     Vector<Complex> shuffled = vec;
     for (int i = shuffled.getSize() - 1; i > 0; --i) {
-        int j = rand() % (i + 1);
+        int j = datagen::threadRng().below(i + 1);
         swap(shuffled[i], shuffled[j]);
     }
     printVector(shuffled, "置乱后向量");
@@ -3,6 +3,7 @@
 #include <cctype>
 #include <cmath>
 #include <stdexcept>
+#include "perfmon.h"
 
 using namespace std;
 
@@ -95,6 +96,7 @@ double calculate(double a, double b, char op) {
 
 // 字符串计算器主函数
 double evaluateExpression(const string& expr) {
+    PERF_SCOPE("calc_evaluate_expression");
     Stack<double> numStack;  // 存储数字的栈
     Stack<char> opStack;     // 存储运算符的栈
     int n = expr.length();
@@ -4,11 +4,14 @@
 #include <cstdlib>
 #include <ctime>
 #include <algorithm>
+#include "datagen.h"
+#include "perfmon.h"
 
 using namespace std;
 
 // 计算柱状图中最大矩形面积（单调栈算法，时间复杂度O(n)）
 int largestRectangleArea(vector<int>& heights) {
+    PERF_SCOPE("histogram_largest_rectangle");
     stack<int> stk;  // 存储柱子索引索引的栈，维持高度递增的柱子索引
     stk.push(-1);    // 哨兵元素，方便处理边界情况
     int maxArea = 0;
@@ -40,19 +43,19 @@ int largestRectangleArea(vector<int>& heights) {
 vector<int> generateRandomHeights(int size) {
     vector<int> heights(size);
     for (int i = 0; i < size; ++i) {
-        heights[i] = rand() % 10001;  // 随机高度：0 <= height <= 10^4
+        heights[i] = datagen::threadRng().range(0, 10000);  // 随机高度：0 <= height <= 10^4
     }
     return heights;
 }
 
 // 测试函数：生成10组数据并验证
 void testLargestRectangle() {
-    srand(time(0));  // 初始化随机数种子
+    // 随机数由datagen.h的固定默认种子生成，可用环境变量 DATAGEN_SEED 更换
     cout << "=== 柱状图最大矩形面积测试 ===" << endl;
     
     for (int i = 0; i < 10; ++i) {
         // 随机生成数组长度：1 <= length <= 10^5
-        int size = rand() % 100000 + 1;
+        int size = datagen::threadRng().range(1, 100000);
         vector<int> heights = generateRandomHeights(size);
         
         // 输出测试信息（大规模数据仅显示基本信息）
@@ -0,0 +1,216 @@
+// 可复现的测试数据生成工具（单头文件）
+// 伪随机数：xoshiro256**，splitmix64扩展种子；jump()跳过2^128步得到互不重叠的子流，用于并行生成
+// 默认种子固定，可用环境变量 DATAGEN_SEED 覆盖；数据集可存为二进制文件，跨版本回放同一份输入
+#ifndef DATAGEN_H
+#define DATAGEN_H
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace datagen {
+
+inline uint64_t splitmix64(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// xoshiro256**：满足UniformRandomBitGenerator，可直接用于std::shuffle等
+class Rng {
+private:
+    uint64_t s[4];
+
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+public:
+    typedef uint64_t result_type;
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~0ULL; }
+
+    explicit Rng(uint64_t seed = 0) { reseed(seed); }
+
+    void reseed(uint64_t seed) {
+        for (int i = 0; i < 4; i++) s[i] = splitmix64(seed);
+    }
+
+    uint64_t next() {
+        uint64_t result = rotl(s[1] * 5, 7) * 9;
+        uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
+    }
+    result_type operator()() { return next(); }
+
+    // 前进2^128步；连续jump得到的各段互不重叠
+    void jump() {
+        static const uint64_t JUMP[] = {0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL,
+                                        0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL};
+        uint64_t t[4] = {0, 0, 0, 0};
+        for (uint64_t j : JUMP) {
+            for (int b = 0; b < 64; b++) {
+                if (j & (1ULL << b)) {
+                    for (int i = 0; i < 4; i++) t[i] ^= s[i];
+                }
+                next();
+            }
+        }
+        memcpy(s, t, sizeof(s));
+    }
+
+    // 拆出一个子流：返回当前状态的副本，自身跳到下一段
+    Rng split() {
+        Rng child = *this;
+        jump();
+        return child;
+    }
+
+    // [0, n) 上的均匀整数（Lemire乘法拒绝法，无取模偏差）
+    uint32_t below(uint32_t n) {
+        uint64_t m = (uint64_t)(uint32_t)(next() >> 32) * n;
+        if ((uint32_t)m < n) {
+            uint32_t threshold = (uint32_t)(-n) % n;
+            while ((uint32_t)m < threshold) m = (uint64_t)(uint32_t)(next() >> 32) * n;
+        }
+        return (uint32_t)(m >> 32);
+    }
+    // [lo, hi] 上的均匀整数
+    int range(int lo, int hi) { return lo + (int)below((uint32_t)(hi - lo) + 1); }
+
+    // [0, 1)
+    double uniform() { return (next() >> 11) * 0x1.0p-53; }
+    // (0, 1]，供log使用，避免log(0)
+    double uniformOpen() { return ((next() >> 11) + 1) * 0x1.0p-53; }
+    double uniform(double lo, double hi) { return lo + (hi - lo) * uniform(); }
+
+    // Box-Muller正态分布
+    double normal(double mu, double sigma) {
+        double u1 = uniformOpen(), u2 = uniform();
+        return mu + sigma * sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+    }
+};
+
+// 全局默认种子：未设置 DATAGEN_SEED 时为固定值，保证每次运行输入相同
+inline uint64_t& defaultSeed() {
+    static uint64_t seed = [] {
+        const char* env = getenv("DATAGEN_SEED");
+        return env ? strtoull(env, nullptr, 0) : 20250101ULL;
+    }();
+    return seed;
+}
+
+// 由默认种子派生的第k个种子：同一进程内多次生成得到不同数据，但整个运行可复现
+inline uint64_t nextSeed() {
+    static std::atomic<uint64_t> counter(0);
+    uint64_t state = defaultSeed() + counter.fetch_add(1) * 0xD1B54A32D192ED03ULL;
+    return splitmix64(state);
+}
+
+// 线程局部生成器，替代rand()
+inline Rng& threadRng() {
+    thread_local Rng rng(nextSeed());
+    return rng;
+}
+
+// 并行生成n个元素：按固定大小分块，第c块使用第c个子流，结果与线程数无关
+// fn(Rng&, size_t i) 生成第i个元素
+const size_t GENERATE_CHUNK = 1 << 16;
+
+template <typename Fn>
+void generateParallel(size_t n, uint64_t seed, int threads, Fn fn) {
+    size_t chunks = (n + GENERATE_CHUNK - 1) / GENERATE_CHUNK;
+    std::vector<Rng> streams;
+    Rng base(seed);
+    for (size_t c = 0; c < chunks; c++) streams.push_back(base.split());
+
+    auto work = [&](size_t first, size_t step) {
+        for (size_t c = first; c < chunks; c += step) {
+            size_t end = std::min(n, (c + 1) * GENERATE_CHUNK);
+            for (size_t i = c * GENERATE_CHUNK; i < end; i++) fn(streams[c], i);
+        }
+    };
+    size_t t = std::max<size_t>(1, std::min<size_t>(threads, chunks));
+    if (t == 1) {
+        work(0, 1);
+        return;
+    }
+    std::vector<std::thread> pool;
+    for (size_t k = 1; k < t; k++) pool.emplace_back(work, k, t);
+    work(0, t);
+    for (std::thread& th : pool) th.join();
+}
+
+// -------------------------- 数据集存取 --------------------------
+// 文件格式：32字节头（"DGN1"、记录大小、记录数、种子、FNV-1a校验和）+ 原始记录
+struct DatasetHeader {
+    char magic[4];
+    uint32_t recordSize;
+    uint64_t count;
+    uint64_t seed;
+    uint64_t checksum;
+};
+
+inline uint64_t checksum(const void* data, size_t bytes) {
+    const unsigned char* p = (const unsigned char*)data;
+    uint64_t h = 0xCBF29CE484222325ULL;
+    for (size_t i = 0; i < bytes; i++) {
+        h ^= p[i];
+        h *= 0x100000001B3ULL;
+    }
+    return h;
+}
+
+template <typename T>
+void saveDataset(const std::string& path, const std::vector<T>& data, uint64_t seed = 0) {
+    static_assert(std::is_trivially_copyable<T>::value, "记录类型必须可按字节复制");
+    DatasetHeader h;
+    memcpy(h.magic, "DGN1", 4);
+    h.recordSize = sizeof(T);
+    h.count = data.size();
+    h.seed = seed;
+    h.checksum = checksum(data.data(), data.size() * sizeof(T));
+    std::ofstream out(path, std::ios::binary);
+    if (!out) throw std::runtime_error("无法写入数据集文件: " + path);
+    out.write((const char*)&h, sizeof(h));
+    out.write((const char*)data.data(), data.size() * sizeof(T));
+    if (!out) throw std::runtime_error("写入数据集文件失败: " + path);
+}
+
+// seed非空时返回生成该数据集所用的种子
+template <typename T>
+std::vector<T> loadDataset(const std::string& path, uint64_t* seed = nullptr) {
+    static_assert(std::is_trivially_copyable<T>::value, "记录类型必须可按字节复制");
+    std::ifstream in(path, std::ios::binary);
+    if (!in) throw std::runtime_error("无法打开数据集文件: " + path);
+    DatasetHeader h;
+    if (!in.read((char*)&h, sizeof(h)) || memcmp(h.magic, "DGN1", 4) != 0) {
+        throw std::runtime_error("不是数据集文件: " + path);
+    }
+    if (h.recordSize != sizeof(T)) throw std::runtime_error("数据集记录大小不匹配: " + path);
+    std::vector<T> data(h.count);
+    if (!in.read((char*)data.data(), h.count * sizeof(T))) throw std::runtime_error("数据集文件不完整: " + path);
+    if (checksum(data.data(), data.size() * sizeof(T)) != h.checksum) {
+        throw std::runtime_error("数据集校验和不符: " + path);
+    }
+    if (seed) *seed = h.seed;
+    return data;
+}
+
+}  // namespace datagen
+
+#endif
@@ -2,8 +2,20 @@
 #include <fstream>
 #include <cstring>
 #include <vector>
-#include <queue>
+#include <stdexcept>
 #include <algorithm>
+#include <iomanip>
+#include <queue>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <chrono>
+#include "datagen.h"
+#include "perfmon.h"
 using namespace std;
 
 // 先定义Rank类型（全局或类外）
@@ -112,183 +124,970 @@ public:
     }
 };
 
+// 节点下标类型：子节点用32位下标引用节点池中的位置
+typedef unsigned int NodeIdx;
+const NodeIdx NIL = 0xFFFFFFFFu; // 空下标（相当于空指针）
+
 // 二叉树节点类（用于构建Huffman树）
 template <typename T>
 struct BinNode {
-    T data;          // 节点数据（Huffman树中存储字符及其频率）
-    BinNode<T>* left; // 左子节点
-    BinNode<T>* right;// 右子节点
+    T data;        // 节点数据（Huffman树中存储字符及其频率）
+    NodeIdx left;  // 左子节点下标
+    NodeIdx right; // 右子节点下标
 
     // 构造函数
-    BinNode(T d = T(), BinNode<T>* l = nullptr, BinNode<T>* r = nullptr)
+    BinNode(T d = T(), NodeIdx l = NIL, NodeIdx r = NIL)
         : data(d), left(l), right(r) {}
 };
 
-// 二叉树类（BinTree）
+// 二叉树类（BinTree）：所有节点存放在一个连续的节点池中
+// 节点池由vector管理，拷贝/移动/析构均按值语义进行，不会重复释放；
+// clear()只重置长度、保留容量，反复建树时不再向分配器申请内存
 template <typename T>
 class BinTree {
 protected:
-    BinNode<T>* root; // 根节点
-
-    // 递归销毁二叉树
-    void destroy(BinNode<T>* node) {
-        if (node) {
-            destroy(node->left);
-            destroy(node->right);
-            delete node;
-        }
-    }
+    vector<BinNode<T>> nodes; // 节点池
+    NodeIdx root;             // 根节点下标
 
 public:
     // 构造函数
-    BinTree() : root(nullptr) {}
+    BinTree() : root(NIL) {}
 
-    // 析构函数
-    ~BinTree() {
-        destroy(root);
+    // 新建节点，返回其下标
+    NodeIdx newNode(const T& d, NodeIdx l = NIL, NodeIdx r = NIL) {
+        nodes.push_back(BinNode<T>(d, l, r));
+        return nodes.size() - 1;
+    }
+
+    // 按下标访问节点（注意：newNode可能使已取得的引用失效）
+    BinNode<T>& node(NodeIdx i) {
+        return nodes[i];
+    }
+
+    const BinNode<T>& node(NodeIdx i) const {
+        return nodes[i];
+    }
+
+    // 整体清空：节点数据可平凡析构时为O(1)
+    void clear() {
+        nodes.clear();
+        root = NIL;
+    }
+
+    // 预留节点池容量
+    void reserve(size_t n) {
+        nodes.reserve(n);
+    }
+
+    // 节点个数
+    size_t size() const {
+        return nodes.size();
     }
 
     // 获取根节点
-    BinNode<T>* getRoot() const {
+    NodeIdx getRoot() const {
         return root;
     }
 
     // 设置根节点
-    void setRoot(BinNode<T>* node) {
-        root = node;
+    void setRoot(NodeIdx i) {
+        root = i;
     }
 
     // 判断是否为空树
     bool isEmpty() const {
-        return root == nullptr;
+        return root == NIL;
+    }
+
+    // 判断是否为叶子节点
+    bool isLeaf(NodeIdx i) const {
+        return nodes[i].left == NIL && nodes[i].right == NIL;
+    }
+
+    // 先序遍历（迭代版，显式栈），visit(节点下标, 深度)
+    template <typename VST>
+    void travPre(VST visit) const {
+        vector<pair<NodeIdx, int>> stk;
+        if (root != NIL) stk.push_back(make_pair(root, 0));
+        while (!stk.empty()) {
+            pair<NodeIdx, int> cur = stk.back();
+            stk.pop_back();
+            visit(cur.first, cur.second);
+            const BinNode<T>& nd = nodes[cur.first];
+            if (nd.right != NIL) stk.push_back(make_pair(nd.right, cur.second + 1));
+            if (nd.left != NIL) stk.push_back(make_pair(nd.left, cur.second + 1));
+        }
+    }
+
+    // 中序遍历（迭代版，显式栈）
+    template <typename VST>
+    void travIn(VST visit) const {
+        vector<NodeIdx> stk;
+        NodeIdx x = root;
+        while (true) {
+            while (x != NIL) {
+                stk.push_back(x);
+                x = nodes[x].left;
+            }
+            if (stk.empty()) break;
+            x = stk.back();
+            stk.pop_back();
+            visit(x);
+            x = nodes[x].right;
+        }
+    }
+
+    // 后序遍历（迭代版，显式栈）
+    template <typename VST>
+    void travPost(VST visit) const {
+        vector<NodeIdx> stk;
+        NodeIdx x = root, last = NIL;
+        while (x != NIL || !stk.empty()) {
+            if (x != NIL) {
+                stk.push_back(x);
+                x = nodes[x].left;
+                continue;
+            }
+            NodeIdx top = stk.back();
+            if (nodes[top].right != NIL && nodes[top].right != last) {
+                x = nodes[top].right;
+            } else {
+                visit(top);
+                last = top;
+                stk.pop_back();
+            }
+        }
     }
 };
 
-// Huffman树节点的数据类型（字符+频率）
+// Huffman编码的最大码长（长度受限，保证解码端可使用固定大小的查找表）
+const int HUFF_MAX_BITS = 15;
+
+// Huffman树节点的数据类型（符号+频率）
 struct HuffNodeData {
-    char ch;      // 字符（'#'表示合并节点）
-    int frequency;// 频率
-    Bitmap code;  // 该字符对应的Huffman编码（位图存储）
+    int sym;                      // 符号（-1表示合并节点）
+    unsigned long long frequency; // 频率
 
     // 构造函数
-    HuffNodeData(char c = '#', int freq = 0) : ch(c), frequency(freq) {}
+    HuffNodeData(int s = -1, unsigned long long freq = 0) : sym(s), frequency(freq) {}
+};
+
+// 规范Huffman编码（码字仅由码长决定，MSB优先）
+struct HuffCode {
+    unsigned int bits; // 码字（低len位有效）
+    int len;           // 码长（0表示该符号未出现）
+
+    HuffCode(unsigned int b = 0, int l = 0) : bits(b), len(l) {}
+};
+
+// 位写入器：按MSB优先顺序把码字追加到字节流
+class BitWriter {
+private:
+    vector<unsigned char>& out;
+    unsigned long long acc; // 位缓冲
+    int nbits;              // 缓冲中的有效位数
+
+public:
+    BitWriter(vector<unsigned char>& o) : out(o), acc(0), nbits(0) {}
+
+    void write(unsigned int bits, int len) {
+        acc = (acc << len) | bits;
+        nbits += len;
+        while (nbits >= 8) {
+            nbits -= 8;
+            out.push_back((unsigned char)(acc >> nbits));
+        }
+    }
 
-    // 重载比较运算符（用于优先队列）
-    bool operator<(const HuffNodeData& other) const {
-        return frequency > other.frequency; // 小顶堆：频率小的优先
+    // 把剩余不足一个字节的位补0写出
+    void flush() {
+        if (nbits > 0) {
+            out.push_back((unsigned char)(acc << (8 - nbits)));
+            nbits = 0;
+        }
+        acc = 0;
     }
 };
 
-// Huffman树类（继承自BinTree）
-class HuffTree : public BinTree<HuffNodeData> {
+// 位读取器：peek固定位数用于查表解码，越过末尾的位视为0
+class BitReader {
 private:
-    // 统计《I Have a Dream》原文中26个字母的频率
-    void countFrequencies(const string& text, vector<int>& freq) {
-        freq.assign(26, 0); // 初始化26个字母的频率为0
-        for (char c : text) {
-            if (isalpha(c)) { // 只处理字母
-                c = tolower(c); // 不区分大小写
-                freq[c - 'a']++;
-            }
+    const unsigned char* p;
+    size_t n;               // 字节数
+    size_t pos;             // 下一个待装入的字节
+    unsigned long long acc; // 位缓冲
+    int nbits;              // 缓冲中的有效位数
+
+    void refill() {
+        while (nbits <= 56) {
+            unsigned char byte = pos < n ? p[pos] : 0;
+            pos++;
+            acc |= (unsigned long long)byte << (56 - nbits);
+            nbits += 8;
         }
     }
 
-    // 递归生成Huffman编码（从根节点遍历到叶子节点）
-    // 递归生成Huffman编码（从根节点遍历到叶子节点）
-    void generateCodes(BinNode<HuffNodeData>* node, Bitmap& currentCode) {
-        if (!node) return;
+public:
+    BitReader(const unsigned char* data, size_t size) : p(data), n(size), pos(0), acc(0), nbits(0) {
+        refill();
+    }
+
+    unsigned int peek(int len) const {
+        return (unsigned int)(acc >> (64 - len));
+    }
+
+    void skip(int len) {
+        acc <<= len;
+        nbits -= len;
+        if (nbits <= 56) refill();
+    }
+};
+
+// 规范Huffman解码器：由码长表重建固定大小（2^HUFF_MAX_BITS项）的查找表
+class HuffDecoder {
+private:
+    vector<unsigned short> table; // 项 = (符号 << 4) | 码长，码长0表示非法码字
+
+public:
+    HuffDecoder(const vector<int>& lengths);
+
+    // 从位流中解码一个符号，遇到非法码字返回-1
+    int decode(BitReader& in) const {
+        unsigned short e = table[in.peek(HUFF_MAX_BITS)];
+        int len = e & 0x0F;
+        if (len == 0) return -1;
+        in.skip(len);
+        return e >> 4;
+    }
+};
+
+// Huffman树类（继承自BinTree）：叶子在节点池前部、合并节点在后部
+class HuffTree : public BinTree<HuffNodeData> {
+private:
+    int alphabetSize;                 // 字母表大小（默认256，即任意字节）
+    vector<unsigned long long> freq;  // 各符号的频率
+    vector<int> codeLen;              // 各符号的码长
+    vector<HuffCode> codes;           // 各符号的规范编码
+    vector<int> leafOrder;            // 建树用的叶子排序缓冲（复用以免重复分配）
 
-        // 如果是叶子节点（存储字母），保存编码
-        if (!node->left && !node->right) {
-            node->data.code = currentCode;
-            return;
+    // 统计字节频率：4张交错的计数表轮流累加，避免相邻相同字节在同一计数器上的存储-加载停顿
+    void countFrequencies(const unsigned char* data, size_t n, vector<unsigned long long>& freq) {
+        unsigned long long cnt[4][256] = {{0}};
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            cnt[0][data[i]]++;
+            cnt[1][data[i + 1]]++;
+            cnt[2][data[i + 2]]++;
+            cnt[3][data[i + 3]]++;
         }
+        for (; i < n; i++) cnt[0][data[i]]++;
 
-        // 左子树：添加0
-        currentCode.set(currentCode.size()); // 扩展一位
-        currentCode.clear(currentCode.size() - 1); // 设为0
-        generateCodes(node->left, currentCode);
-        currentCode.clear(currentCode.size() - 1); // 回溯（清除最后一位）
+        freq.assign(alphabetSize, 0);
+        for (int s = 0; s < 256; s++) {
+            unsigned long long total = cnt[0][s] + cnt[1][s] + cnt[2][s] + cnt[3][s];
+            if (total == 0) continue;
+            if (s >= alphabetSize) {
+                throw runtime_error("符号超出字母表范围: " + to_string(s));
+            }
+            freq[s] = total;
+        }
+    }
 
-        // 右子树：添加1
-        currentCode.set(currentCode.size() - 1); // 设为1
-        generateCodes(node->right, currentCode);
-        currentCode.clear(currentCode.size() - 1); // 回溯（清除最后一位）
+    // 先序遍历求叶子深度，即码长
+    void computeLengths() {
+        codeLen.assign(alphabetSize, 0);
+        travPre([this](NodeIdx i, int depth) {
+            const HuffNodeData& d = node(i).data;
+            if (d.sym >= 0) codeLen[d.sym] = max(depth, 1); // 只有一个符号时码长取1
+        });
     }
 
 public:
-    // 构建Huffman树
+    // 构造函数：指定字母表大小（1~256）
+    HuffTree(int alphabet = 256) : alphabetSize(alphabet) {
+        if (alphabet < 1 || alphabet > 256) {
+            throw runtime_error("字母表大小必须在1~256之间");
+        }
+    }
+
+    // 构建Huffman树（双队列线性合并，节点取自节点池）
     void build(const string& text) {
-        vector<int> freq;
-        countFrequencies(text, freq); // 统计频率
-
-        // 优先队列（小顶堆）：存储Huffman树节点
-        priority_queue<BinNode<HuffNodeData>*> pq;
-
-        // 1. 创建叶子节点（只处理频率大于0的字母）
-        for (int i = 0; i < 26; i++) {
-            if (freq[i] > 0) {
-                BinNode<HuffNodeData>* leaf = new BinNode<HuffNodeData>(
-                    HuffNodeData('a' + i, freq[i])
-                );
-                pq.push(leaf);
+        build((const unsigned char*)text.data(), text.size());
+    }
+
+    void build(const unsigned char* data, size_t n) {
+        PERF_SCOPE("huffman_tree_build");
+        PERF_COUNT("huffman_input_bytes", n);
+        countFrequencies(data, n, freq); // 统计频率
+        buildFromFrequencies(freq);
+    }
+
+    // 由频率表构建：叶子按频率升序排列构成第一个队列，合并节点按生成顺序天然有序构成第二个队列
+    void buildFromFrequencies(const vector<unsigned long long>& f) {
+        if (&f != &freq) freq = f;
+        freq.resize(alphabetSize, 0);
+        clear();
+
+        // 1. 创建叶子节点（只处理频率大于0的符号），按频率升序、同频按符号排列
+        leafOrder.clear();
+        for (int s = 0; s < alphabetSize; s++) {
+            if (freq[s] > 0) leafOrder.push_back(s);
+        }
+        stable_sort(leafOrder.begin(), leafOrder.end(), [this](int a, int b) {
+            return freq[a] < freq[b];
+        });
+        NodeIdx leafCount = leafOrder.size();
+        if (leafCount > 1) reserve(2 * leafCount - 1);
+        for (int s : leafOrder) newNode(HuffNodeData(s, freq[s]));
+
+        // 2. 每次从两个队列的队头取出频率最小的两个节点合并（同频时优先取叶子，码长更均衡）
+        NodeIdx leafHead = 0, mergedHead = leafCount;
+        auto popMin = [&]() {
+            if (leafHead < leafCount &&
+                (mergedHead >= size() || node(leafHead).data.frequency <= node(mergedHead).data.frequency)) {
+                return leafHead++;
             }
+            return mergedHead++;
+        };
+        for (NodeIdx k = 1; k < leafCount; k++) {
+            NodeIdx left = popMin();
+            NodeIdx right = popMin();
+            newNode(HuffNodeData(-1, node(left).data.frequency + node(right).data.frequency), left, right);
         }
+        if (size() > 0) setRoot(size() - 1);
 
-        // 2. 构建Huffman树
-        while (pq.size() > 1) {
-            // 取出频率最小的两个节点
-            BinNode<HuffNodeData>* left = pq.top(); pq.pop();
-            BinNode<HuffNodeData>* right = pq.top(); pq.pop();
+        // 3. 由树形只取码长，再做长度限制和规范编码分配
+        computeLengths();
+        limitCodeLengths(codeLen, freq, HUFF_MAX_BITS);
+        codes = assignCanonicalCodes(codeLen);
+    }
 
-            // 创建合并节点（字符为'#'，频率为两个节点之和）
-            BinNode<HuffNodeData>* parent = new BinNode<HuffNodeData>(
-                HuffNodeData('#', left->data.frequency + right->data.frequency),
-                left, right
-            );
+    // 长度限制（启发式）：先把超长码截断到maxBits，再按Kraft不等式修正
+    // 修正时优先加长频率最低的次长码，最后把多余的编码空间还给高频符号
+    static void limitCodeLengths(vector<int>& len, const vector<unsigned long long>& freq, int maxBits) {
+        long long kraft = 0;             // Σ 2^(maxBits - len)
+        const long long full = 1LL << maxBits;
+        for (int& l : len) {
+            if (l > maxBits) l = maxBits;
+            if (l > 0) kraft += 1LL << (maxBits - l);
+        }
 
-            pq.push(parent);
+        // 编码空间超额：把某个码长<maxBits的符号加长一位，释放 2^(maxBits-len-1)
+        while (kraft > full) {
+            int best = -1;
+            for (int s = 0; s < (int)len.size(); s++) {
+                if (len[s] <= 0 || len[s] >= maxBits) continue;
+                if (best < 0 || len[s] > len[best] ||
+                    (len[s] == len[best] && freq[s] < freq[best])) {
+                    best = s;
+                }
+            }
+            kraft -= 1LL << (maxBits - len[best] - 1);
+            len[best]++;
         }
 
-        // 3. 设置根节点
-        if (!pq.empty()) {
-            setRoot(pq.top());
-            // 生成Huffman编码
-            Bitmap currentCode;
-            generateCodes(getRoot(), currentCode);
+        // 编码空间有剩余：按频率从高到低尝试缩短码长
+        vector<int> order;
+        for (int s = 0; s < (int)len.size(); s++) {
+            if (len[s] > 0) order.push_back(s);
+        }
+        sort(order.begin(), order.end(), [&](int a, int b) { return freq[a] > freq[b]; });
+        for (int s : order) {
+            while (len[s] > 1 && kraft + (1LL << (maxBits - len[s])) <= full) {
+                kraft += 1LL << (maxBits - len[s]);
+                len[s]--;
+            }
         }
     }
 
-    // 根据字符获取对应的Huffman编码（返回字符串形式）
-    char* getCode(char ch) {
-        if (!isalpha(ch)) return nullptr;
-        ch = tolower(ch);
+    // 规范编码分配：同码长的码字按符号顺序连续递增，短码在前（与DEFLATE相同）
+    static vector<HuffCode> assignCanonicalCodes(const vector<int>& len) {
+        int blCount[HUFF_MAX_BITS + 1] = {0};
+        for (int l : len) {
+            if (l > 0) blCount[l]++;
+        }
 
-        // 递归查找字符对应的节点
-        BinNode<HuffNodeData>* node = findNode(getRoot(), ch);
-        if (!node) return nullptr;
+        unsigned int nextCode[HUFF_MAX_BITS + 2] = {0};
+        unsigned int code = 0;
+        for (int bits = 1; bits <= HUFF_MAX_BITS; bits++) {
+            code = (code + blCount[bits - 1]) << 1;
+            nextCode[bits] = code;
+        }
+
+        vector<HuffCode> result(len.size());
+        for (int s = 0; s < (int)len.size(); s++) {
+            if (len[s] > 0) {
+                result[s] = HuffCode(nextCode[len[s]]++, len[s]);
+            }
+        }
+        return result;
+    }
+
+    // 写出紧凑的码表头：每个符号的码长占4位，两个符号一个字节
+    static void writeCodeLengths(const vector<int>& len, vector<unsigned char>& out) {
+        for (size_t s = 0; s < len.size(); s += 2) {
+            int hi = len[s];
+            int lo = s + 1 < len.size() ? len[s + 1] : 0;
+            out.push_back((unsigned char)((hi << 4) | lo));
+        }
+    }
+
+    // 读取码表头，返回码长表
+    static vector<int> readCodeLengths(const unsigned char* p, int alphabetSize) {
+        vector<int> len(alphabetSize);
+        for (int s = 0; s < alphabetSize; s++) {
+            len[s] = (s & 1) ? (p[s >> 1] & 0x0F) : (p[s >> 1] >> 4);
+        }
+        return len;
+    }
+
+    // 码表头的字节数
+    static int headerBytes(int alphabetSize) {
+        return (alphabetSize + 1) / 2;
+    }
+
+    // 获取字母表大小
+    int getAlphabetSize() const {
+        return alphabetSize;
+    }
+
+    // 获取码长表（解码端只需要它）
+    const vector<int>& getCodeLengths() const {
+        return codeLen;
+    }
+
+    // 根据符号获取对应的Huffman编码（返回字符串形式）
+    char* getCode(unsigned char ch) {
+        if (ch >= codes.size()) return nullptr;
+
+        const HuffCode& c = codes[ch];
+        if (c.len == 0) return nullptr;
+
+        char* s = new char[c.len + 1];
+        for (int i = 0; i < c.len; i++) {
+            s[i] = ((c.bits >> (c.len - 1 - i)) & 1) ? '1' : '0';
+        }
+        s[c.len] = '\0';
+        return s;
+    }
+
+    // 压缩：[码表头][4字节符号数][码字位流]
+    vector<unsigned char> encode(const string& text) const {
+        vector<unsigned char> out;
+        encode((const unsigned char*)text.data(), text.size(), out);
+        return out;
+    }
+
+    // 压缩并追加到out末尾（块压缩复用同一个输出缓冲）
+    void encode(const unsigned char* data, size_t n, vector<unsigned char>& out) const {
+        out.reserve(out.size() + headerBytes(alphabetSize) + 4 + n);
+        writeCodeLengths(codeLen, out);
+
+        unsigned int count = n;
+        for (int k = 0; k < 4; k++) out.push_back((unsigned char)(count >> (8 * k)));
+
+        BitWriter bw(out);
+        for (size_t i = 0; i < n; i++) {
+            const HuffCode& code = codes[data[i]];
+            if (code.len == 0) {
+                throw runtime_error("符号不在码表中: " + to_string(data[i]));
+            }
+            bw.write(code.bits, code.len);
+        }
+        bw.flush();
+    }
 
-        // 将位图编码转换为字符串
-        return node->data.code.bits2string(node->data.code.size());
+    // 解压：只依赖码表头重建解码表，不需要Huffman树
+    static string decode(const vector<unsigned char>& data, int alphabetSize = 256) {
+        return decode(data.data(), data.size(), alphabetSize);
     }
 
+    // maxCount：调用方已知的原文长度上限（如块大小），超过即视为数据损坏
+    static string decode(const unsigned char* data, size_t size, int alphabetSize = 256, size_t maxCount = (size_t)-1) {
+        size_t hb = headerBytes(alphabetSize);
+        if (size < hb + 4) throw runtime_error("压缩数据不完整");
+        HuffDecoder decoder(readCodeLengths(data, alphabetSize));
+
+        unsigned int count = 0;
+        for (int k = 0; k < 4; k++) count |= (unsigned int)data[hb + k] << (8 * k);
+        // 每个符号至少占1位，符号数不可能超过载荷位数；先校验再分配
+        if (count > maxCount || count > (unsigned long long)(size - hb - 4) * 8) throw runtime_error("压缩数据长度字段非法");
+
+        string text(count, '\0');
+        BitReader br(data + hb + 4, size - hb - 4);
+        for (unsigned int i = 0; i < count; i++) {
+            int sym = decoder.decode(br);
+            if (sym < 0) throw runtime_error("非法的Huffman码字");
+            text[i] = (char)sym;
+        }
+        return text;
+    }
+};
+
+// 由码长表构建查找表：每个码字占据以它为前缀的全部 2^(HUFF_MAX_BITS-len) 项
+// 码长来自文件头，先校验范围与Kraft不等式（Σ 2^(HUFF_MAX_BITS-len) ≤ 2^HUFF_MAX_BITS），超额的码表会写出查找表
+HuffDecoder::HuffDecoder(const vector<int>& lengths) : table(1 << HUFF_MAX_BITS, 0) {
+    long long kraft = 0;
+    for (int len : lengths) {
+        if (len < 0 || len > HUFF_MAX_BITS) throw runtime_error("码长超出范围");
+        if (len > 0) kraft += 1LL << (HUFF_MAX_BITS - len);
+    }
+    if (kraft > (1LL << HUFF_MAX_BITS)) throw runtime_error("码长表不满足Kraft不等式");
+
+    vector<HuffCode> codes = HuffTree::assignCanonicalCodes(lengths);
+    for (int s = 0; s < (int)codes.size(); s++) {
+        int len = codes[s].len;
+        if (len == 0) continue;
+        unsigned int first = codes[s].bits << (HUFF_MAX_BITS - len);
+        unsigned int span = 1u << (HUFF_MAX_BITS - len);
+        for (unsigned int k = 0; k < span; k++) {
+            table[first + k] = (unsigned short)((s << 4) | len);
+        }
+    }
+}
+
+// ============================== 块并行压缩容器 ==============================
+// 文件格式（小端）：
+//   文件头：   "HUFB" | 版本(1B) | 保留(3B) | 块大小(4B)
+//   块记录：   模式(1B: 0=原样存储, 1=Huffman) | 原始长度(4B) | 载荷长度(4B) | 载荷
+//   块索引：   每块 { 块记录偏移(8B) | 原始长度(4B) | 记录长度(4B) }
+//   文件尾：   块数(8B) | 索引偏移(8B) | "HUFI"
+// 每个块有独立的规范码表，可并行压缩/解压，并可借助块索引随机访问任意块。
+const char HUFB_MAGIC[4] = {'H', 'U', 'F', 'B'};
+const char HUFI_MAGIC[4] = {'H', 'U', 'F', 'I'};
+const unsigned char HUFB_VERSION = 1;
+const int HUFB_HEADER_BYTES = 12;
+const int HUFB_FOOTER_BYTES = 20;
+const int BLOCK_RECORD_HEADER = 9;
+const unsigned char BLOCK_STORED = 0;
+const unsigned char BLOCK_HUFFMAN = 1;
+
+void putU32(vector<unsigned char>& out, unsigned int v) {
+    for (int k = 0; k < 4; k++) out.push_back((unsigned char)(v >> (8 * k)));
+}
+
+void putU64(vector<unsigned char>& out, unsigned long long v) {
+    for (int k = 0; k < 8; k++) out.push_back((unsigned char)(v >> (8 * k)));
+}
+
+unsigned int getU32(const unsigned char* p) {
+    unsigned int v = 0;
+    for (int k = 0; k < 4; k++) v |= (unsigned int)p[k] << (8 * k);
+    return v;
+}
+
+unsigned long long getU64(const unsigned char* p) {
+    unsigned long long v = 0;
+    for (int k = 0; k < 8; k++) v |= (unsigned long long)p[k] << (8 * k);
+    return v;
+}
+
+// 块索引项
+struct BlockIndexEntry {
+    unsigned long long offset; // 块记录在文件中的偏移
+    unsigned int rawSize;      // 原始长度
+    unsigned int recordSize;   // 块记录总长度（含记录头）
+};
+
+// 简单线程池：固定数量的工作线程 + 任务队列
+class ThreadPool {
 private:
-    // 递归查找存储指定字符的节点
-    BinNode<HuffNodeData>* findNode(BinNode<HuffNodeData>* node, char ch) {
-        if (!node) return nullptr;
+    vector<thread> workers;
+    queue<function<void()>> tasks;
+    mutex mtx;
+    condition_variable cv;
+    bool stopping;
 
-        // 找到叶子节点且字符匹配
-        if (!node->left && !node->right && node->data.ch == ch) {
-            return node;
+public:
+    ThreadPool(int n) : stopping(false) {
+        if (n < 1) n = 1;
+        for (int i = 0; i < n; i++) {
+            workers.emplace_back([this]() {
+                while (true) {
+                    function<void()> task;
+                    {
+                        unique_lock<mutex> lock(mtx);
+                        cv.wait(lock, [this]() { return stopping || !tasks.empty(); });
+                        if (stopping && tasks.empty()) return;
+                        task = move(tasks.front());
+                        tasks.pop();
+                    }
+                    task();
+                }
+            });
         }
+    }
 
-        // 递归查找左右子树
-        BinNode<HuffNodeData>* leftResult = findNode(node->left, ch);
-        if (leftResult) return leftResult;
-        return findNode(node->right, ch);
+    ~ThreadPool() {
+        {
+            lock_guard<mutex> lock(mtx);
+            stopping = true;
+        }
+        cv.notify_all();
+        for (thread& t : workers) t.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // 提交任务，返回结果的future（任务中的异常会在get()时重新抛出）
+    template <typename F>
+    auto submit(F f) -> future<decltype(f())> {
+        auto task = make_shared<packaged_task<decltype(f())()>>(move(f));
+        future<decltype(f())> result = task->get_future();
+        {
+            lock_guard<mutex> lock(mtx);
+            tasks.push([task]() { (*task)(); });
+        }
+        cv.notify_one();
+        return result;
+    }
+
+    int size() const {
+        return workers.size();
     }
 };
 
+// 压缩单个块，生成完整的块记录；Huffman结果不比原文小时改为原样存储
+vector<unsigned char> compressBlock(const vector<unsigned char>& raw) {
+    vector<unsigned char> rec;
+    rec.push_back(BLOCK_HUFFMAN);
+    putU32(rec, raw.size());
+    putU32(rec, 0); // 载荷长度，稍后回填
+
+    static thread_local HuffTree tree; // 每个工作线程复用同一棵树的节点池
+    tree.build(raw.data(), raw.size());
+    tree.encode(raw.data(), raw.size(), rec);
+
+    if (rec.size() - BLOCK_RECORD_HEADER >= raw.size()) {
+        rec.resize(BLOCK_RECORD_HEADER);
+        rec[0] = BLOCK_STORED;
+        rec.insert(rec.end(), raw.begin(), raw.end());
+    }
+    unsigned int payload = rec.size() - BLOCK_RECORD_HEADER;
+    for (int k = 0; k < 4; k++) rec[5 + k] = (unsigned char)(payload >> (8 * k));
+    return rec;
+}
+
+// 解压单个块记录；expectedSize为块索引中的原始长度（已按文件头的块大小校验）
+string decompressBlock(const vector<unsigned char>& rec, unsigned int expectedSize) {
+    if (rec.size() < BLOCK_RECORD_HEADER) throw runtime_error("块记录不完整");
+    unsigned int rawSize = getU32(rec.data() + 1);
+    unsigned int payload = getU32(rec.data() + 5);
+    if (rec.size() != BLOCK_RECORD_HEADER + (size_t)payload) throw runtime_error("块记录长度不一致");
+    if (rawSize != expectedSize) throw runtime_error("块记录与块索引的原始长度不一致");
+
+    const unsigned char* p = rec.data() + BLOCK_RECORD_HEADER;
+    string out;
+    if (rec[0] == BLOCK_STORED) {
+        out.assign((const char*)p, payload);
+    } else if (rec[0] == BLOCK_HUFFMAN) {
+        out = HuffTree::decode(p, payload, 256, rawSize);
+    } else {
+        throw runtime_error("未知的块模式");
+    }
+    if (out.size() != rawSize) throw runtime_error("块解压长度不一致");
+    return out;
+}
+
+// RAII文件句柄（使用64位偏移，支持超过4GB的文件）
+class File {
+private:
+    FILE* fp;
+
+public:
+    File(const string& path, const char* mode) : fp(fopen(path.c_str(), mode)) {
+        if (!fp) throw runtime_error("无法打开文件: " + path);
+    }
+
+    ~File() {
+        if (fp) fclose(fp);
+    }
+
+    File(const File&) = delete;
+    File& operator=(const File&) = delete;
+
+    // 最多读取n字节，返回实际读取的字节数
+    size_t read(void* buf, size_t n) {
+        return fread(buf, 1, n, fp);
+    }
+
+    // 精确读取n字节，不足则报错
+    void readExact(void* buf, size_t n) {
+        if (fread(buf, 1, n, fp) != n) throw runtime_error("文件读取失败（数据不完整）");
+    }
+
+    void write(const void* buf, size_t n) {
+        if (n > 0 && fwrite(buf, 1, n, fp) != n) throw runtime_error("文件写入失败");
+    }
+
+    void seek(unsigned long long off) {
+        if (fseeko(fp, (off_t)off, SEEK_SET) != 0) throw runtime_error("文件定位失败");
+    }
+
+    unsigned long long size() {
+        off_t cur = ftello(fp);
+        fseeko(fp, 0, SEEK_END);
+        off_t end = ftello(fp);
+        fseeko(fp, cur, SEEK_SET);
+        return end;
+    }
+};
+
+// 块并行压缩：流式读入，最多同时保留 2×线程数 个块在内存中，按顺序写出
+unsigned long long compressFile(const string& inPath, const string& outPath, unsigned int blockSize, ThreadPool& pool) {
+    if (blockSize == 0) throw runtime_error("块大小必须大于0");
+    File in(inPath, "rb");
+    File out(outPath, "wb");
+
+    vector<unsigned char> header(HUFB_MAGIC, HUFB_MAGIC + 4);
+    header.push_back(HUFB_VERSION);
+    header.insert(header.end(), 3, 0);
+    putU32(header, blockSize);
+    out.write(header.data(), header.size());
+
+    vector<BlockIndexEntry> index;
+    unsigned long long offset = HUFB_HEADER_BYTES;
+    size_t window = 2 * pool.size();
+    deque<pair<unsigned int, future<vector<unsigned char>>>> inflight;
+
+    auto drainOne = [&]() {
+        vector<unsigned char> rec = inflight.front().second.get();
+        index.push_back({offset, inflight.front().first, (unsigned int)rec.size()});
+        out.write(rec.data(), rec.size());
+        offset += rec.size();
+        inflight.pop_front();
+    };
+
+    while (true) {
+        vector<unsigned char> raw(blockSize);
+        size_t n = in.read(raw.data(), blockSize);
+        if (n == 0) break;
+        raw.resize(n);
+        if (inflight.size() >= window) drainOne();
+        inflight.emplace_back((unsigned int)n, pool.submit([raw = move(raw)]() { return compressBlock(raw); }));
+    }
+    while (!inflight.empty()) drainOne();
+
+    vector<unsigned char> tail;
+    for (const BlockIndexEntry& e : index) {
+        putU64(tail, e.offset);
+        putU32(tail, e.rawSize);
+        putU32(tail, e.recordSize);
+    }
+    putU64(tail, index.size());
+    putU64(tail, offset);
+    tail.insert(tail.end(), HUFI_MAGIC, HUFI_MAGIC + 4);
+    out.write(tail.data(), tail.size());
+    return offset + tail.size();
+}
+
+// 读取并校验文件头与块索引：每个块记录须落在文件头与索引之间，原始长度不超过块大小
+vector<BlockIndexEntry> readBlockIndex(File& in, unsigned int* blockSize = nullptr) {
+    unsigned long long fileSize = in.size();
+    if (fileSize < HUFB_HEADER_BYTES + HUFB_FOOTER_BYTES) throw runtime_error("不是有效的HUFB文件");
+
+    unsigned char header[HUFB_HEADER_BYTES];
+    in.seek(0);
+    in.readExact(header, sizeof(header));
+    if (memcmp(header, HUFB_MAGIC, 4) != 0 || header[4] != HUFB_VERSION) {
+        throw runtime_error("不是有效的HUFB文件");
+    }
+    unsigned int maxBlock = getU32(header + 8);
+    if (maxBlock == 0) throw runtime_error("HUFB块大小非法");
+    if (blockSize) *blockSize = maxBlock;
+
+    unsigned char footer[HUFB_FOOTER_BYTES];
+    in.seek(fileSize - HUFB_FOOTER_BYTES);
+    in.readExact(footer, sizeof(footer));
+    if (memcmp(footer + 16, HUFI_MAGIC, 4) != 0) throw runtime_error("HUFB文件尾损坏");
+    unsigned long long count = getU64(footer);
+    unsigned long long indexOffset = getU64(footer + 8);
+    if (count > fileSize / 16 || indexOffset < HUFB_HEADER_BYTES ||
+        indexOffset + count * 16 + HUFB_FOOTER_BYTES != fileSize) {
+        throw runtime_error("HUFB块索引损坏");
+    }
+
+    vector<unsigned char> raw(count * 16);
+    in.seek(indexOffset);
+    in.readExact(raw.data(), raw.size());
+    vector<BlockIndexEntry> index(count);
+    for (size_t i = 0; i < count; i++) {
+        const unsigned char* p = raw.data() + 16 * i;
+        index[i] = {getU64(p), getU32(p + 8), getU32(p + 12)};
+        const BlockIndexEntry& e = index[i];
+        if (e.offset < HUFB_HEADER_BYTES || e.offset > indexOffset || e.recordSize < BLOCK_RECORD_HEADER ||
+            e.recordSize > indexOffset - e.offset || e.rawSize > maxBlock) {
+            throw runtime_error("HUFB块索引项 " + to_string(i) + " 越界");
+        }
+    }
+    return index;
+}
+
+// 读取单个块记录
+vector<unsigned char> readBlockRecord(File& in, const BlockIndexEntry& e) {
+    vector<unsigned char> rec(e.recordSize);
+    in.seek(e.offset);
+    in.readExact(rec.data(), rec.size());
+    return rec;
+}
+
+// 块并行解压：按索引流式读取块记录，窗口大小同压缩端，按顺序写出
+unsigned long long decompressFile(const string& inPath, const string& outPath, ThreadPool& pool) {
+    File in(inPath, "rb");
+    vector<BlockIndexEntry> index = readBlockIndex(in);
+    File out(outPath, "wb");
+
+    unsigned long long total = 0;
+    size_t window = 2 * pool.size();
+    deque<future<string>> inflight;
+
+    auto drainOne = [&]() {
+        string block = inflight.front().get();
+        out.write(block.data(), block.size());
+        total += block.size();
+        inflight.pop_front();
+    };
+
+    for (const BlockIndexEntry& e : index) {
+        vector<unsigned char> rec = readBlockRecord(in, e);
+        if (inflight.size() >= window) drainOne();
+        unsigned int rawSize = e.rawSize;
+        inflight.push_back(pool.submit([rec = move(rec), rawSize]() { return decompressBlock(rec, rawSize); }));
+    }
+    while (!inflight.empty()) drainOne();
+    return total;
+}
+
+// 随机访问：只解压第k个块
+string extractBlock(const string& inPath, size_t k) {
+    File in(inPath, "rb");
+    vector<BlockIndexEntry> index = readBlockIndex(in);
+    if (k >= index.size()) throw runtime_error("块号超出范围（共 " + to_string(index.size()) + " 块）");
+    return decompressBlock(readBlockRecord(in, index[k]), index[k].rawSize);
+}
+
+// 生成类日志的测试数据（时间戳+级别+模块+消息），用于没有输入文件时的基准测试
+void generateLogData(const string& path, unsigned long long bytes) {
+    static const char* levels[] = {"INFO", "WARN", "DEBUG", "ERROR"};
+    static const char* modules[] = {"net", "disk", "sched", "auth", "cache"};
+    File out(path, "wb");
+    unsigned long long written = 0;
+    datagen::Rng rng(88172645463325252ULL);
+    char line[160];
+    while (written < bytes) {
+        unsigned long long x = rng.next();
+        int len = snprintf(line, sizeof(line), "2025-%02d-%02d %02d:%02d:%02d.%03d [%s] %s: request id=%llu latency=%lluus status=%d\n",
+                           (int)(x % 12) + 1, (int)(x >> 8) % 28 + 1, (int)(x >> 16) % 24, (int)(x >> 24) % 60,
+                           (int)(x >> 32) % 60, (int)(x >> 40) % 1000, levels[(x >> 44) & 3], modules[(x >> 46) % 5],
+                           (x >> 20) % 100000, (x >> 30) % 5000, (x & 1) ? 200 : 404);
+        out.write(line, len);
+        written += len;
+    }
+}
+
+// 比较两个文件内容是否一致
+bool sameFile(const string& a, const string& b) {
+    File fa(a, "rb"), fb(b, "rb");
+    vector<char> ba(1 << 20), bb(1 << 20);
+    while (true) {
+        size_t na = fa.read(ba.data(), ba.size());
+        size_t nb = fb.read(bb.data(), bb.size());
+        if (na != nb || memcmp(ba.data(), bb.data(), na) != 0) return false;
+        if (na == 0) return true;
+    }
+}
+
+// 基准测试：分别用1个线程和全部线程压缩/解压，报告总吞吐和每核吞吐（MB/s）
+void runBenchmark(const string& input, unsigned int blockSize, int threads) {
+    string packedPath = input + ".hufb.tmp";
+    string restoredPath = input + ".out.tmp";
+    File probe(input, "rb");
+    double mb = probe.size() / 1048576.0;
+
+    cout << "输入：" << input << "（" << fixed << setprecision(1) << mb << " MB），块大小："
+         << blockSize / 1024 << " KB" << endl;
+    cout << setw(8) << "线程数" << setw(14) << "压缩MB/s" << setw(14) << "每核" << setw(14) << "解压MB/s"
+         << setw(14) << "每核" << setw(10) << "压缩率" << endl;
+
+    vector<int> counts = {1};
+    if (threads > 1) counts.push_back(threads);
+    for (int t : counts) {
+        ThreadPool pool(t);
+        auto t0 = chrono::steady_clock::now();
+        unsigned long long packed = compressFile(input, packedPath, blockSize, pool);
+        auto t1 = chrono::steady_clock::now();
+        decompressFile(packedPath, restoredPath, pool);
+        auto t2 = chrono::steady_clock::now();
+
+        double cs = chrono::duration<double>(t1 - t0).count();
+        double ds = chrono::duration<double>(t2 - t1).count();
+        if (!sameFile(input, restoredPath)) throw runtime_error("基准测试校验失败：解压结果与原文件不一致");
+        cout << setw(8) << t << setw(14) << setprecision(1) << mb / cs << setw(14) << mb / cs / t
+             << setw(14) << mb / ds << setw(14) << mb / ds / t
+             << setw(9) << setprecision(1) << 100.0 * packed / max(1.0, mb * 1048576.0) << "%" << endl;
+    }
+    remove(packedPath.c_str());
+    remove(restoredPath.c_str());
+}
+
+void printUsage(const char* prog) {
+    cout << "用法：" << endl;
+    cout << "  " << prog << "                                  运行Huffman编码演示" << endl;
+    cout << "  " << prog << " c <输入> <输出> [块KB] [线程数]    块并行压缩" << endl;
+    cout << "  " << prog << " d <输入> <输出> [线程数]           块并行解压" << endl;
+    cout << "  " << prog << " x <输入> <块号> <输出>             随机访问：只解压一个块" << endl;
+    cout << "  " << prog << " bench [输入] [块KB] [线程数]       压缩/解压吞吐基准（无输入时生成64MB日志）" << endl;
+}
+
+// 解析以KB为单位的块大小，范围1KB~1GB（块记录中的长度字段为32位）
+unsigned int parseBlockSize(const char* arg) {
+    unsigned long kb = stoul(arg);
+    if (kb < 1 || kb > (1UL << 20)) throw invalid_argument("块大小须在1~1048576 KB之间");
+    return (unsigned int)kb * 1024;
+}
+
+// 命令行入口，返回进程退出码
+int runCli(int argc, char* argv[]) {
+    string cmd = argv[1];
+    int hw = max(1u, thread::hardware_concurrency());
+    try {
+        if (cmd == "c" && argc >= 4) {
+            unsigned int blockSize = argc >= 5 ? parseBlockSize(argv[4]) : 1024 * 1024;
+            ThreadPool pool(argc >= 6 ? stoi(argv[5]) : hw);
+            unsigned long long packed = compressFile(argv[2], argv[3], blockSize, pool);
+            cout << "压缩完成：" << packed << " 字节" << endl;
+        } else if (cmd == "d" && argc >= 4) {
+            ThreadPool pool(argc >= 5 ? stoi(argv[4]) : hw);
+            unsigned long long total = decompressFile(argv[2], argv[3], pool);
+            cout << "解压完成：" << total << " 字节" << endl;
+        } else if (cmd == "x" && argc >= 5) {
+            string block = extractBlock(argv[2], stoul(argv[3]));
+            File out(argv[4], "wb");
+            out.write(block.data(), block.size());
+            cout << "第 " << argv[3] << " 块：" << block.size() << " 字节" << endl;
+        } else if (cmd == "bench") {
+            string input = argc >= 3 ? argv[2] : "";
+            unsigned int blockSize = argc >= 4 ? parseBlockSize(argv[3]) : 1024 * 1024;
+            int threads = argc >= 5 ? stoi(argv[4]) : hw;
+            bool generated = input.empty();
+            if (generated) {
+                input = "huff_bench_input.tmp";
+                generateLogData(input, 64ULL << 20);
+            }
+            runBenchmark(input, blockSize, threads);
+            if (generated) remove(input.c_str());
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    } catch (const exception& e) {
+        cerr << "错误: " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
+
 // 测试用例：《I Have a Dream》演讲片段（用于统计频率）
 const string I_HAVE_A_DREAM = R"(
 I have a dream that one day this nation will rise up and live out the true meaning of its creed:
@@ -303,7 +1102,6 @@ I have a dream today!
 string encodeWord(const string& word, HuffTree& huffTree) {
     string encoded;
     for (char c : word) {
-        if (!isalpha(c)) continue; // 只编码字母
         char* code = huffTree.getCode(c);
         if (code) {
             encoded += code;
@@ -314,7 +1112,9 @@ string encodeWord(const string& word, HuffTree& huffTree) {
     return encoded;
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+    if (argc > 1) return runCli(argc, argv);
+
     // 1. 构建Huffman树
     HuffTree huffTree;
     huffTree.build(I_HAVE_A_DREAM);
@@ -329,17 +1129,27 @@ int main() {
         cout << word << ": " << encoded << endl;
     }
 
-    // 3. 单独展示每个字母的编码
+    // 3. 单独展示每个字母的编码（字母表为全部256个字节，这里只列出字母）
     cout << "\n字母编码对照表：" << endl;
     cout << "==================" << endl;
-    for (char c = 'a'; c <= 'z'; c++) {
+    for (int c = 0; c < 256; c++) {
+        if (!isalpha(c)) continue;
         char* code = huffTree.getCode(c);
         if (code) {
-            cout << c << ": " << code << endl;
+            cout << (char)c << ": " << code << endl;
             delete[] code;
         }
     }
 
+    // 4. 规范码表头与压缩/解压往返（按原始字节，含空格、标点和换行）
+    vector<unsigned char> packed = huffTree.encode(I_HAVE_A_DREAM);
+    string unpacked = HuffTree::decode(packed);
+    cout << "\n规范Huffman压缩：" << endl;
+    cout << "==================" << endl;
+    cout << "码表头：" << HuffTree::headerBytes(huffTree.getAlphabetSize()) << " 字节（仅码长，最长 " << HUFF_MAX_BITS << " 位）" << endl;
+    cout << "原文：" << I_HAVE_A_DREAM.size() << " 字节，压缩后：" << packed.size() << " 字节" << endl;
+    cout << "解压校验：" << (unpacked == I_HAVE_A_DREAM ? "通过" : "失败") << endl;
+
     return 0;
 
 }
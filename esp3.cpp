@@ -3,281 +3,2584 @@
 #include <queue>
 #include <stack>
 #include <climits>
+#include <cmath>
 #include <algorithm>
 #include <map>
 #include <set>
 #include <string>
 #include <tuple>
+#include <stdexcept>
+#include <cstdio>
+#include <cstring>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <iomanip>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "datagen.h"
+#include "perfmon.h"
 using namespace std;
 
-// ============================== 图数据结构类 ==============================
+// ============================== 整数编号的CSR图 ==============================
+typedef int VertexId;   // 顶点编号（0 ~ n-1）
+typedef int Weight;     // 边权
+typedef long long EdgeId; // 弧编号（CSR中的下标，可超过2^31）
+
+// 边（建图用的边表元素）
+struct Edge {
+    VertexId u, v;
+    Weight w;
+
+    Edge(VertexId a = 0, VertexId b = 0, Weight wt = 0) : u(a), v(b), w(wt) {}
+};
+
+// 邻居（目标顶点+边权）
+struct Neighbor {
+    VertexId v;
+    Weight w;
+};
+
+// 邻居区间：直接指向CSR内部数组，不拷贝、不分配
+class NeighborSpan {
+private:
+    const VertexId* tgt;
+    const Weight* wt;
+    size_t cnt;
+
+public:
+    NeighborSpan(const VertexId* t, const Weight* w, size_t n) : tgt(t), wt(w), cnt(n) {}
+
+    struct iterator {
+        const VertexId* t;
+        const Weight* w;
+        Neighbor operator*() const { return Neighbor{*t, *w}; }
+        iterator& operator++() { ++t; ++w; return *this; }
+        bool operator!=(const iterator& o) const { return t != o.t; }
+    };
+
+    iterator begin() const { return iterator{tgt, wt}; }
+    iterator end() const { return iterator{tgt + cnt, wt + cnt}; }
+    size_t size() const { return cnt; }
+    bool empty() const { return cnt == 0; }
+    Neighbor operator[](size_t i) const { return Neighbor{tgt[i], wt[i]}; }
+    const VertexId* targets() const { return tgt; }
+    const Weight* weights() const { return wt; }
+};
+
+// 只读内存映射文件（RAII，析构时解除映射）
+class MappedFile {
+private:
+    void* addr;
+    size_t len;
+
+public:
+    explicit MappedFile(const string& path) : addr(nullptr), len(0) {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw runtime_error("无法打开文件: " + path);
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            close(fd);
+            throw runtime_error("无法获取文件大小: " + path);
+        }
+        len = st.st_size;
+        if (len > 0) {
+            addr = mmap(nullptr, len, PROT_READ, MAP_SHARED, fd, 0);
+            if (addr == MAP_FAILED) {
+                close(fd);
+                throw runtime_error("mmap失败: " + path);
+            }
+        }
+        close(fd); // 映射建立后即可关闭描述符
+    }
+
+    ~MappedFile() {
+        if (addr) munmap(addr, len);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return (const char*)addr; }
+    size_t size() const { return len; }
+};
+
+// 压缩稀疏行（CSR）图：offsets[u]..offsets[u+1] 为顶点u的出弧，每行按目标顶点升序
+// 内存为 O(V + E)，无向图每条边存两条弧
+// 三个数组通过指针访问：建图得到的图指向自有vector，mapFile得到的图直接指向映射的文件
+class CSRGraph {
+private:
+    int n;                          // 顶点数
+    bool directed;                  // 是否有向
+    vector<EdgeId> offsetStore;     // 自有存储（映射模式下为空）
+    vector<VertexId> targetStore;
+    vector<Weight> weightStore;
+    shared_ptr<MappedFile> mapping; // 映射模式下持有文件映射，拷贝共享
+    const EdgeId* offsets;          // 行偏移，长度 n+1
+    const VertexId* targets;        // 弧的目标顶点
+    const Weight* weights;          // 弧的权重
+
+    // 指针指向自有vector（拷贝/移动/建图后调用）
+    void bindOwned() {
+        offsets = offsetStore.data();
+        targets = targetStore.data();
+        weights = weightStore.data();
+    }
+
+    void assignFrom(const CSRGraph& o) {
+        if (o.mapping) {
+            offsets = o.offsets;
+            targets = o.targets;
+            weights = o.weights;
+        } else {
+            bindOwned();
+        }
+    }
+
+public:
+    CSRGraph() : n(0), directed(false), offsetStore(1, 0) {
+        bindOwned();
+    }
+
+    CSRGraph(const CSRGraph& o)
+        : n(o.n), directed(o.directed), offsetStore(o.offsetStore), targetStore(o.targetStore),
+          weightStore(o.weightStore), mapping(o.mapping) {
+        assignFrom(o);
+    }
+
+    CSRGraph(CSRGraph&& o) noexcept
+        : n(o.n), directed(o.directed), offsetStore(move(o.offsetStore)), targetStore(move(o.targetStore)),
+          weightStore(move(o.weightStore)), mapping(o.mapping) {
+        assignFrom(o);
+    }
+
+    CSRGraph& operator=(CSRGraph o) {
+        n = o.n;
+        directed = o.directed;
+        offsetStore.swap(o.offsetStore);
+        targetStore.swap(o.targetStore);
+        weightStore.swap(o.weightStore);
+        mapping = o.mapping;
+        assignFrom(o);
+        return *this;
+    }
+
+    // 由边表建图：无向图自动补反向弧；同一(u,v)多次出现时保留最后一次的权重
+    // 两趟稳定计数排序（先按目标、再按源）得到按目标有序的行，整体 O(V + E)
+    static CSRGraph fromEdges(int n, const vector<Edge>& edges, bool directed) {
+        size_t m = directed ? edges.size() : 2 * edges.size();
+        vector<Edge> arcs;
+        arcs.reserve(m);
+        for (const Edge& e : edges) {
+            if (e.u < 0 || e.u >= n || e.v < 0 || e.v >= n) {
+                throw out_of_range("边的端点超出顶点范围");
+            }
+            arcs.push_back(e);
+            if (!directed) arcs.push_back(Edge(e.v, e.u, e.w));
+        }
+
+        // 第一趟：按目标顶点稳定计数排序
+        vector<EdgeId> cnt(n + 1, 0);
+        for (const Edge& e : arcs) cnt[e.v + 1]++;
+        for (int i = 0; i < n; ++i) cnt[i + 1] += cnt[i];
+        vector<Edge> byTarget(m);
+        for (const Edge& e : arcs) byTarget[cnt[e.v]++] = e;
+        vector<Edge>().swap(arcs);
+
+        // 第二趟：按源顶点稳定计数排序，直接写入CSR数组
+        CSRGraph g;
+        g.n = n;
+        g.directed = directed;
+        g.offsetStore.assign(n + 1, 0);
+        for (const Edge& e : byTarget) g.offsetStore[e.u + 1]++;
+        for (int i = 0; i < n; ++i) g.offsetStore[i + 1] += g.offsetStore[i];
+        g.targetStore.resize(m);
+        g.weightStore.resize(m);
+        vector<EdgeId> pos(g.offsetStore.begin(), g.offsetStore.end() - 1);
+        for (const Edge& e : byTarget) {
+            EdgeId p = pos[e.u]++;
+            g.targetStore[p] = e.v;
+            g.weightStore[p] = e.w;
+        }
+
+        // 去重：每行内相同目标相邻，保留最后一次出现的权重
+        EdgeId out = 0;
+        for (int u = 0; u < n; ++u) {
+            EdgeId begin = g.offsetStore[u], end = g.offsetStore[u + 1];
+            g.offsetStore[u] = out;
+            for (EdgeId e = begin; e < end; ++e) {
+                if (e + 1 < end && g.targetStore[e + 1] == g.targetStore[e]) continue;
+                g.targetStore[out] = g.targetStore[e];
+                g.weightStore[out] = g.weightStore[e];
+                out++;
+            }
+        }
+        g.offsetStore[n] = out;
+        g.targetStore.resize(out);
+        g.weightStore.resize(out);
+        g.targetStore.shrink_to_fit();
+        g.weightStore.shrink_to_fit();
+        g.bindOwned();
+        return g;
+    }
+
+    // 反向图（有向图求入弧用；无向图的反向图与自身相同）
+    CSRGraph reversed() const {
+        vector<Edge> edges;
+        edges.reserve(numArcs());
+        for (VertexId u = 0; u < n; ++u) {
+            for (EdgeId e = offsets[u]; e < offsets[u + 1]; ++e) {
+                edges.push_back(Edge(targets[e], u, weights[e]));
+            }
+        }
+        CSRGraph r = fromEdges(n, edges, true);
+        r.directed = directed;
+        return r;
+    }
+
+    int numVertices() const { return n; }
+    EdgeId numArcs() const { return offsets[n]; }
+    bool isDirected() const { return directed; }
+    EdgeId degree(VertexId u) const { return offsets[u + 1] - offsets[u]; }
+    EdgeId edgeBegin(VertexId u) const { return offsets[u]; }
+    EdgeId edgeEnd(VertexId u) const { return offsets[u + 1]; }
+    VertexId target(EdgeId e) const { return targets[e]; }
+    Weight weight(EdgeId e) const { return weights[e]; }
+
+    // 顶点u的邻居区间（零拷贝）
+    NeighborSpan neighbors(VertexId u) const {
+        EdgeId b = offsets[u];
+        return NeighborSpan(targets + b, weights + b, offsets[u + 1] - b);
+    }
+
+    // 是否为文件映射（只读，零拷贝）
+    bool isMapped() const { return mapping != nullptr; }
+
+    // 二进制CSR文件（本机字节序）：
+    //   [0,32)  头部：魔数"CSR1"、u32标志（bit0=有向）、u64 顶点数、u64 弧数、u64 保留
+    //   offsets (n+1)×8字节，随后 targets m×4字节、weights m×4字节，各段天然对齐，可直接映射使用
+    void save(const string& path) const {
+        FILE* fp = fopen(path.c_str(), "wb");
+        if (!fp) throw runtime_error("无法写入文件: " + path);
+        unsigned int flags = directed ? 1 : 0;
+        unsigned long long header[3] = {(unsigned long long)n, (unsigned long long)numArcs(), 0};
+        fwrite("CSR1", 1, 4, fp);
+        fwrite(&flags, sizeof(flags), 1, fp);
+        fwrite(header, sizeof(header), 1, fp);
+        fwrite(offsets, sizeof(EdgeId), n + 1, fp);
+        fwrite(targets, sizeof(VertexId), numArcs(), fp);
+        fwrite(weights, sizeof(Weight), numArcs(), fp);
+        bool ok = ferror(fp) == 0;
+        if (fclose(fp) != 0) ok = false;
+        if (!ok) throw runtime_error("写入CSR文件失败: " + path);
+    }
+
+    // 映射CSR文件：校验头部、文件长度与offsets（单调不减且不超过弧数，O(n)），
+    // targets/weights的页面在首次访问时才由内核读入；弧目标的范围由validate检查
+    static CSRGraph mapFile(const string& path) {
+        shared_ptr<MappedFile> file = make_shared<MappedFile>(path);
+        const char* p = file->data();
+        if (file->size() < 32 || memcmp(p, "CSR1", 4) != 0) throw runtime_error("不是CSR文件: " + path);
+        unsigned int flags;
+        unsigned long long header[3];
+        memcpy(&flags, p + 4, sizeof(flags));
+        memcpy(header, p + 8, sizeof(header));
+        unsigned long long nv = header[0], m = header[1];
+        // 先限定m再相乘，避免构造的m使乘积回绕后恰好通过长度校验
+        const unsigned long long arcBytes = sizeof(VertexId) + sizeof(Weight);
+        if (nv > (unsigned long long)INT_MAX || m > (file->size() - 32) / arcBytes ||
+            file->size() != 32 + (nv + 1) * sizeof(EdgeId) + m * arcBytes) {
+            throw runtime_error("CSR文件损坏: " + path);
+        }
+        CSRGraph g;
+        g.n = (int)nv;
+        g.directed = flags & 1;
+        g.offsetStore.clear();
+        g.offsets = (const EdgeId*)(p + 32);
+        g.targets = (const VertexId*)(p + 32 + (nv + 1) * sizeof(EdgeId));
+        g.weights = (const Weight*)((const char*)g.targets + m * sizeof(VertexId));
+        if (g.offsets[0] != 0 || (unsigned long long)g.offsets[nv] != m) throw runtime_error("CSR文件损坏: " + path);
+        for (unsigned long long u = 0; u < nv; ++u) {
+            if (g.offsets[u + 1] < g.offsets[u]) throw runtime_error("CSR文件损坏: " + path);
+        }
+        g.mapping = file;
+        return g;
+    }
+
+    // 检查所有弧目标都在[0, n)内（O(m)，会读入整个targets段）；不合法时抛出异常
+    void validate() const {
+        for (EdgeId e = 0; e < numArcs(); ++e) {
+            if (targets[e] < 0 || targets[e] >= n) throw runtime_error("CSR文件损坏：弧 " + to_string(e) + " 的目标越界");
+        }
+    }
+};
+
+// ============================== 并行工具 ==============================
+// 简单线程池：固定数量的工作线程 + 任务队列
+class ThreadPool {
+private:
+    vector<thread> workers;
+    queue<function<void()>> tasks;
+    mutex mtx;
+    condition_variable cv;
+    bool stopping;
+
+public:
+    ThreadPool(int n) : stopping(false) {
+        if (n < 1) n = 1;
+        for (int i = 0; i < n; i++) {
+            workers.emplace_back([this]() {
+                while (true) {
+                    function<void()> task;
+                    {
+                        unique_lock<mutex> lock(mtx);
+                        cv.wait(lock, [this]() { return stopping || !tasks.empty(); });
+                        if (stopping && tasks.empty()) return;
+                        task = move(tasks.front());
+                        tasks.pop();
+                    }
+                    task();
+                }
+            });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            lock_guard<mutex> lock(mtx);
+            stopping = true;
+        }
+        cv.notify_all();
+        for (thread& t : workers) t.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // 提交任务，返回结果的future（任务中的异常会在get()时重新抛出）
+    template <typename F>
+    auto submit(F f) -> future<decltype(f())> {
+        auto task = make_shared<packaged_task<decltype(f())()>>(move(f));
+        future<decltype(f())> result = task->get_future();
+        {
+            lock_guard<mutex> lock(mtx);
+            tasks.push([task]() { (*task)(); });
+        }
+        cv.notify_one();
+        return result;
+    }
+
+    int size() const {
+        return workers.size();
+    }
+};
+
+// 并行for：把[0,n)切成chunks块交给线程池，fn(begin, end, 块号)，全部完成后返回
+template <typename F>
+void parallelFor(ThreadPool& pool, size_t n, int chunks, F fn) {
+    if (n == 0) return;
+    chunks = max(1, (int)min((size_t)chunks, n));
+    if (chunks == 1) {
+        fn((size_t)0, n, 0);
+        return;
+    }
+    vector<future<void>> done;
+    for (int c = 0; c < chunks; ++c) {
+        size_t b = n * c / chunks, e = n * (c + 1) / chunks;
+        done.push_back(pool.submit([=, &fn]() { fn(b, e, c); }));
+    }
+    for (auto& f : done) f.get();
+}
+
+// ============================== 边表导入 ==============================
+// 解析一个整数（可带负号），p前进到数字之后；没有数字或绝对值超过2^31
+// （不可能是合法的顶点编号或边权，继续累加会溢出）时返回false
+bool parseNumber(const char*& p, const char* end, long long& out) {
+    bool neg = false;
+    if (p < end && *p == '-') {
+        neg = true;
+        ++p;
+    }
+    if (p >= end || *p < '0' || *p > '9') return false;
+    long long x = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        x = x * 10 + (*p++ - '0');
+        if (x > (long long)INT_MAX + 1) return false;
+    }
+    out = neg ? -x : x;
+    return true;
+}
+
+// 解析[b,e)中的完整行："u v [w]"，分隔符为空格、制表符或逗号，缺省权重为1；
+// 空行、以#或%开头的注释行以及首字符不是数字的行（如CSV表头）被跳过
+void parseEdgeLines(const char* b, const char* e, vector<Edge>& out, long long& maxId) {
+    auto skipSep = [&](const char*& p) {
+        while (p < e && (*p == ' ' || *p == '\t' || *p == ',' || *p == '\r')) ++p;
+    };
+    const char* p = b;
+    while (p < e) {
+        const char* lineEnd = (const char*)memchr(p, '\n', e - p);
+        if (!lineEnd) lineEnd = e;
+        const char* q = p;
+        skipSep(q);
+        if (q < lineEnd && ((*q >= '0' && *q <= '9') || *q == '-')) {
+            long long u, v, w = 1;
+            bool ok = parseNumber(q, lineEnd, u);
+            skipSep(q);
+            ok = ok && parseNumber(q, lineEnd, v);
+            skipSep(q);
+            if (ok && q < lineEnd && !parseNumber(q, lineEnd, w)) ok = false;
+            if (!ok || u < 0 || v < 0 || u > INT_MAX - 1 || v > INT_MAX - 1 || w < INT_MIN || w > INT_MAX) {
+                throw runtime_error("边表格式错误: " + string(p, min<size_t>(lineEnd - p, 60)));
+            }
+            out.push_back(Edge((VertexId)u, (VertexId)v, (Weight)w));
+            maxId = max(maxId, max(u, v));
+        }
+        p = lineEnd + 1;
+    }
+}
+
+// 流式导入文本/CSV边表：按块读入（块在最后一个换行处截断，余下部分并入下一块），
+// 每块按行边界切分后由线程池并行解析，最后计数排序建CSR。顶点数为最大编号+1。
+CSRGraph importEdgeList(const string& path, bool directed, ThreadPool& pool, size_t blockBytes = 64 << 20) {
+    FILE* fp = fopen(path.c_str(), "rb");
+    if (!fp) throw runtime_error("无法打开文件: " + path);
+    int pieces = 4 * pool.size();
+    vector<char> buf(blockBytes);
+    vector<vector<Edge>> parts(pieces);
+    vector<long long> partMax(pieces);
+    vector<Edge> edges;
+    long long maxId = -1;
+    size_t carry = 0;
+    try {
+        while (true) {
+            if (carry == buf.size()) buf.resize(buf.size() * 2); // 单行超过块大小
+            size_t got = fread(buf.data() + carry, 1, buf.size() - carry, fp);
+            if (ferror(fp)) throw runtime_error("读取边表失败: " + path);
+            size_t len = carry + got;
+            bool eof = got == 0 || feof(fp);
+            size_t cut = len;
+            if (!eof) {
+                const char* nl = (const char*)memrchr(buf.data(), '\n', len);
+                cut = nl ? nl - buf.data() + 1 : 0;
+            }
+
+            // 把[0,cut)切成pieces段，每段起点对齐到行首
+            vector<size_t> bounds(pieces + 1, cut);
+            bounds[0] = 0;
+            for (int c = 1; c < pieces; ++c) {
+                size_t pos = max(bounds[c - 1], cut * c / pieces);
+                if (pos > 0 && pos < cut && buf[pos - 1] != '\n') {
+                    const char* nl = (const char*)memchr(buf.data() + pos, '\n', cut - pos);
+                    pos = nl ? nl - buf.data() + 1 : cut;
+                }
+                bounds[c] = pos;
+            }
+            parallelFor(pool, pieces, pieces, [&](size_t b, size_t e, int) {
+                for (size_t c = b; c < e; ++c) {
+                    parts[c].clear();
+                    partMax[c] = -1;
+                    parseEdgeLines(buf.data() + bounds[c], buf.data() + bounds[c + 1], parts[c], partMax[c]);
+                }
+            });
+            for (int c = 0; c < pieces; ++c) {
+                edges.insert(edges.end(), parts[c].begin(), parts[c].end());
+                maxId = max(maxId, partMax[c]);
+            }
+
+            carry = len - cut;
+            memmove(buf.data(), buf.data() + cut, carry);
+            if (eof) break;
+        }
+    } catch (...) {
+        fclose(fp);
+        throw;
+    }
+    fclose(fp);
+    return CSRGraph::fromEdges((int)(maxId + 1), edges, directed);
+}
+
+// ============================== 图数据结构类（字符标签层） ==============================
+// 以字符作为顶点标签的薄封装：标签与整数编号互相映射，边存放在CSR中
+// addEdge只记录边，首次查询时才（重新）构建CSR
 class Graph {
 public:
-    map<char, int> vertexToIdx;
-    vector<char> idxToVertex;
-    vector<vector<int>> adjMatrix;
+    vector<int> vertexToIdx;  // 标签 -> 编号（按unsigned char下标，-1表示不存在）
+    vector<char> idxToVertex; // 编号 -> 标签
     bool isDirected;
 
-    Graph(const vector<char>& vertices, bool directed = false) {
-        this->isDirected = directed;
-        int n = vertices.size();
-        for (int i = 0; i < n; ++i) {
-            vertexToIdx[vertices[i]] = i;
-            idxToVertex.push_back(vertices[i]);
+    Graph(const vector<char>& vertices, bool directed = false) : vertexToIdx(256, -1) {
+        this->isDirected = directed;
+        int n = vertices.size();
+        for (int i = 0; i < n; ++i) {
+            vertexToIdx[(unsigned char)vertices[i]] = i;
+            idxToVertex.push_back(vertices[i]);
+        }
+    }
+
+    void addEdge(char v1, char v2, int weight) {
+        edges.push_back(Edge(id(v1), id(v2), weight));
+        dirty = true;
+    }
+
+    // 标签 -> 编号
+    VertexId id(char v) const {
+        int i = vertexToIdx[(unsigned char)v];
+        if (i < 0) throw out_of_range(string("未知顶点: ") + v);
+        return i;
+    }
+
+    // 编号 -> 标签
+    char label(VertexId i) const {
+        return idxToVertex[i];
+    }
+
+    int numVertices() const {
+        return idxToVertex.size();
+    }
+
+    // 底层CSR图（整数编号）
+    const CSRGraph& csr() const {
+        if (dirty) {
+            adj = CSRGraph::fromEdges(numVertices(), edges, isDirected);
+            dirty = false;
+        }
+        return adj;
+    }
+
+    void printAdjMatrix() {
+        int n = idxToVertex.size();
+        cout << "邻接矩阵（行/列：";
+        for (char v : idxToVertex) cout << v << " ";
+        cout << "）：\n";
+        vector<int> row(n);
+        for (int i = 0; i < n; ++i) {
+            fill(row.begin(), row.end(), 0);
+            for (Neighbor nb : csr().neighbors(i)) row[nb.v] = nb.w;
+            cout << idxToVertex[i] << ":\t";
+            for (int j = 0; j < n; ++j) {
+                cout << row[j] << "\t";
+            }
+            cout << "\n";
+        }
+    }
+
+    vector<pair<char, int>> getAdjacent(char v) {
+        vector<pair<char, int>> adj;
+        for (Neighbor nb : csr().neighbors(id(v))) {
+            if (nb.w > 0) {
+                adj.emplace_back(idxToVertex[nb.v], nb.w);
+            }
+        }
+        return adj;
+    }
+
+private:
+    vector<Edge> edges;       // 已添加的边
+    mutable CSRGraph adj;     // 由edges构建的CSR
+    mutable bool dirty = true;
+};
+
+// ============================== 任务2：BFS 和 DFS 算法 ==============================
+// BFS结果：层号（不可达为-1）、BFS树父节点（根与不可达为-1）、访问顺序（按层，层内顺序见各模式说明）
+struct BFSResult {
+    vector<int> level;
+    vector<VertexId> parent;
+    vector<VertexId> order;
+};
+
+enum class BFSMode {
+    Deterministic,        // 串行自顶向下，邻居按编号升序，结果完全确定
+    DirectionOptimizing   // 并行，按frontier规模在自顶向下/自底向上之间切换
+};
+
+// 高性能BFS：访问标记为位图（每顶点1位）。
+// 自顶向下：frontier中的顶点并行扫描出边，用原子fetch_or认领未访问的邻居；
+// 自底向上：未访问顶点按64位字分块并行扫描入边，只要某个入邻居在frontier位图中即被认领，
+//           每个字只由一个线程写，因此无需原子认领。
+// 切换条件（Beamer）：frontier出边数 > 未访问顶点边数/alpha 时转自底向上，frontier顶点数 < n/beta 时转回。
+class ParallelBFS {
+private:
+    const CSRGraph& g;
+    CSRGraph reverseGraph;        // 有向图的入边（自底向上用）
+    const CSRGraph* in;
+    ThreadPool& pool;
+    int alpha, beta;
+    size_t words;
+    unique_ptr<atomic<unsigned long long>[]> visited;
+    vector<unsigned long long> frontierBits, nextBits;
+
+    bool testBit(const vector<unsigned long long>& bits, VertexId v) const {
+        return (bits[v >> 6] >> (v & 63)) & 1;
+    }
+
+    // 原子认领：v此前未被访问时返回true
+    bool claim(VertexId v) {
+        unsigned long long mask = 1ULL << (v & 63);
+        if (visited[v >> 6].load(memory_order_relaxed) & mask) return false;
+        return !(visited[v >> 6].fetch_or(mask, memory_order_relaxed) & mask);
+    }
+
+public:
+    ParallelBFS(const CSRGraph& graph, ThreadPool& tp, int a = 15, int b = 18)
+        : g(graph), in(&graph), pool(tp), alpha(a), beta(b) {
+        if (g.isDirected()) {
+            reverseGraph = g.reversed();
+            in = &reverseGraph;
+        }
+        words = (g.numVertices() + 63) / 64;
+        visited.reset(new atomic<unsigned long long>[max<size_t>(words, 1)]);
+        frontierBits.assign(words, 0);
+        nextBits.assign(words, 0);
+    }
+
+    BFSResult run(VertexId source, BFSMode mode = BFSMode::DirectionOptimizing) {
+        int n = g.numVertices();
+        BFSResult res;
+        res.level.assign(n, -1);
+        res.parent.assign(n, -1);
+        res.order.reserve(n);
+        for (size_t w = 0; w < words; ++w) visited[w].store(0, memory_order_relaxed);
+
+        claim(source);
+        res.level[source] = 0;
+        res.order.push_back(source);
+        vector<VertexId> frontier(1, source);
+        EdgeId unexploredEdges = g.numArcs() - g.degree(source);
+        bool bottomUp = false;
+        int chunks = mode == BFSMode::Deterministic ? 1 : 4 * pool.size();
+        vector<vector<VertexId>> local(chunks);
+
+        for (int depth = 0; !frontier.empty(); ++depth) {
+            if (mode == BFSMode::DirectionOptimizing) {
+                EdgeId frontierEdges = 0;
+                for (VertexId u : frontier) frontierEdges += g.degree(u);
+                if (!bottomUp && frontierEdges > unexploredEdges / alpha) bottomUp = true;
+                else if (bottomUp && (long long)frontier.size() < n / beta) bottomUp = false;
+            }
+            for (auto& l : local) l.clear();
+
+            if (!bottomUp) {
+                int c = frontier.size() < 256 ? 1 : chunks;
+                parallelFor(pool, frontier.size(), c, [&](size_t b, size_t e, int chunk) {
+                    vector<VertexId>& next = local[chunk];
+                    for (size_t i = b; i < e; ++i) {
+                        VertexId u = frontier[i];
+                        for (Neighbor nb : g.neighbors(u)) {
+                            if (claim(nb.v)) {
+                                res.parent[nb.v] = u;
+                                res.level[nb.v] = depth + 1;
+                                next.push_back(nb.v);
+                            }
+                        }
+                    }
+                });
+            } else {
+                fill(frontierBits.begin(), frontierBits.end(), 0);
+                for (VertexId u : frontier) frontierBits[u >> 6] |= 1ULL << (u & 63);
+                parallelFor(pool, words, chunks, [&](size_t b, size_t e, int chunk) {
+                    vector<VertexId>& next = local[chunk];
+                    for (size_t w = b; w < e; ++w) {
+                        unsigned long long seen = visited[w].load(memory_order_relaxed);
+                        if (seen == ~0ULL) continue;
+                        unsigned long long add = 0;
+                        for (int bit = 0; bit < 64; ++bit) {
+                            VertexId v = (VertexId)(w * 64 + bit);
+                            if (v >= n) break;
+                            if ((seen >> bit) & 1) continue;
+                            for (Neighbor nb : in->neighbors(v)) {
+                                if (testBit(frontierBits, nb.v)) {
+                                    res.parent[v] = nb.v;
+                                    res.level[v] = depth + 1;
+                                    add |= 1ULL << bit;
+                                    next.push_back(v);
+                                    break;
+                                }
+                            }
+                        }
+                        if (add) visited[w].fetch_or(add, memory_order_relaxed);
+                    }
+                });
+            }
+
+            frontier.clear();
+            for (auto& l : local) frontier.insert(frontier.end(), l.begin(), l.end());
+            for (VertexId v : frontier) {
+                res.order.push_back(v);
+                unexploredEdges -= g.degree(v);
+            }
+        }
+        return res;
+    }
+};
+
+// 字符标签层BFS（保持原有接口，邻居按标签顺序访问）
+vector<char> BFS(Graph& graph, char start) {
+    const CSRGraph& g = graph.csr();
+    vector<char> result;
+    // 标签按编号递增时，CSR中按编号有序的邻居即按标签有序，可直接使用确定性BFS
+    if (is_sorted(graph.idxToVertex.begin(), graph.idxToVertex.end(), [](char a, char b) {
+            return (unsigned char)a < (unsigned char)b;
+        })) {
+        ThreadPool pool(1);
+        ParallelBFS bfs(g, pool);
+        for (VertexId v : bfs.run(graph.id(start), BFSMode::Deterministic).order) result.push_back(graph.label(v));
+        return result;
+    }
+
+    // 否则逐个顶点按标签排序邻居（标签图至多256个顶点）
+    vector<char> visited(graph.numVertices(), 0);
+    queue<VertexId> q;
+    q.push(graph.id(start));
+    visited[graph.id(start)] = 1;
+    vector<VertexId> adj;
+    while (!q.empty()) {
+        VertexId curr = q.front();
+        q.pop();
+        result.push_back(graph.label(curr));
+        adj.clear();
+        for (Neighbor nb : g.neighbors(curr)) adj.push_back(nb.v);
+        sort(adj.begin(), adj.end(), [&](VertexId a, VertexId b) {
+            return (unsigned char)graph.label(a) < (unsigned char)graph.label(b);
+        });
+        for (VertexId v : adj) {
+            if (!visited[v]) {
+                visited[v] = 1;
+                q.push(v);
+            }
+        }
+    }
+    return result;
+}
+
+// DFS访问者：引擎在对应事件时回调，派生类按需覆盖（模板静态分派，无虚函数开销）
+// 有向图中指向已完成顶点的边（前向边/横叉边）归为otherEdge；
+// 无向图每条边会从两端各看到一次，回到DFS树父节点的那条弧不回调。
+struct DFSVisitor {
+    void discover(VertexId) {}
+    void finish(VertexId) {}
+    void treeEdge(VertexId, VertexId) {}
+    void backEdge(VertexId, VertexId) {}
+    void otherEdge(VertexId, VertexId) {}
+};
+
+// 显式栈DFS：栈帧为(顶点, 下一条待扫描弧)，深度只受内存限制，百万级顶点的长链也不会栈溢出
+class DFSEngine {
+private:
+    enum Color : char { WHITE, GRAY, BLACK };
+    struct Frame {
+        VertexId v;
+        EdgeId next;
+    };
+
+    const CSRGraph& g;
+    vector<char> color;
+    vector<Frame> stk;
+
+public:
+    explicit DFSEngine(const CSRGraph& graph) : g(graph), color(graph.numVertices(), WHITE) {}
+
+    void reset() {
+        fill(color.begin(), color.end(), WHITE);
+    }
+
+    bool visited(VertexId v) const {
+        return color[v] != WHITE;
+    }
+
+    // 从source出发搜索其可达的未访问顶点（已访问顶点保持不变，可多次调用组成森林）
+    template <class Visitor>
+    void run(VertexId source, Visitor& vis) {
+        if (color[source] != WHITE) return;
+        bool undirected = !g.isDirected();
+        color[source] = GRAY;
+        vis.discover(source);
+        stk.push_back({source, g.edgeBegin(source)});
+        while (!stk.empty()) {
+            Frame& f = stk.back();
+            VertexId u = f.v;
+            if (f.next == g.edgeEnd(u)) {
+                color[u] = BLACK;
+                stk.pop_back();
+                vis.finish(u);
+                continue;
+            }
+            VertexId v = g.target(f.next++);
+            if (color[v] == WHITE) {
+                vis.treeEdge(u, v);
+                color[v] = GRAY;
+                vis.discover(v);
+                stk.push_back({v, g.edgeBegin(v)}); // f此后失效
+            } else if (color[v] == GRAY) {
+                if (undirected && stk.size() >= 2 && stk[stk.size() - 2].v == v) continue;
+                vis.backEdge(u, v);
+            } else if (!undirected) {
+                vis.otherEdge(u, v);
+            }
+        }
+    }
+
+    // 按编号顺序从每个未访问顶点出发，遍历整张图
+    template <class Visitor>
+    void runAll(Visitor& vis) {
+        for (VertexId v = 0; v < g.numVertices(); ++v) run(v, vis);
+    }
+};
+
+// 拓扑排序（有向图）：DFS完成顺序的逆序；存在环时返回false
+bool topologicalSort(const CSRGraph& g, vector<VertexId>& order) {
+    if (!g.isDirected()) throw invalid_argument("拓扑排序要求有向图");
+    struct TopoVisitor : DFSVisitor {
+        vector<VertexId>& out;
+        bool acyclic = true;
+        explicit TopoVisitor(vector<VertexId>& o) : out(o) {}
+        void finish(VertexId v) { out.push_back(v); }
+        void backEdge(VertexId, VertexId) { acyclic = false; }
+    };
+    order.clear();
+    order.reserve(g.numVertices());
+    TopoVisitor vis(order);
+    DFSEngine dfs(g);
+    dfs.runAll(vis);
+    reverse(order.begin(), order.end());
+    return vis.acyclic;
+}
+
+// 强连通分量结果：comp[v]为分量编号，编号顺序为缩点图的逆拓扑序（Tarjan的出栈顺序）
+struct SCCResult {
+    vector<int> comp;
+    int count = 0;
+};
+
+// Tarjan强连通分量（有向图），基于DFSEngine，无递归
+SCCResult stronglyConnectedComponents(const CSRGraph& g) {
+    if (!g.isDirected()) throw invalid_argument("强连通分量要求有向图");
+    int n = g.numVertices();
+    struct TarjanVisitor : DFSVisitor {
+        SCCResult& res;
+        vector<int> index, low;
+        vector<char> onStack;
+        vector<VertexId> sccStack, path; // path为当前DFS树路径，用于完成时回传low值
+        int counter = 0;
+
+        TarjanVisitor(SCCResult& r, int n) : res(r), index(n, -1), low(n, 0), onStack(n, 0) {}
+
+        void discover(VertexId v) {
+            index[v] = low[v] = counter++;
+            sccStack.push_back(v);
+            onStack[v] = 1;
+            path.push_back(v);
+        }
+        void backEdge(VertexId u, VertexId v) { low[u] = min(low[u], index[v]); }
+        void otherEdge(VertexId u, VertexId v) {
+            if (onStack[v]) low[u] = min(low[u], index[v]);
+        }
+        void finish(VertexId v) {
+            path.pop_back();
+            if (!path.empty()) low[path.back()] = min(low[path.back()], low[v]);
+            if (low[v] != index[v]) return;
+            VertexId w;
+            do {
+                w = sccStack.back();
+                sccStack.pop_back();
+                onStack[w] = 0;
+                res.comp[w] = res.count;
+            } while (w != v);
+            ++res.count;
+        }
+    };
+    SCCResult res;
+    res.comp.assign(n, -1);
+    TarjanVisitor vis(res, n);
+    DFSEngine dfs(g);
+    dfs.runAll(vis);
+    return res;
+}
+
+// 按标签顺序重新编号后的CSR（rank[id]为标签排名），使编号顺序即标签顺序
+CSRGraph labelOrderedCSR(const Graph& graph, vector<VertexId>& byRank) {
+    const CSRGraph& g = graph.csr();
+    int n = g.numVertices();
+    byRank.resize(n);
+    for (VertexId i = 0; i < n; ++i) byRank[i] = i;
+    sort(byRank.begin(), byRank.end(), [&](VertexId a, VertexId b) {
+        return (unsigned char)graph.label(a) < (unsigned char)graph.label(b);
+    });
+    vector<VertexId> rank(n);
+    for (VertexId r = 0; r < n; ++r) rank[byRank[r]] = r;
+    vector<Edge> edges;
+    for (VertexId u = 0; u < n; ++u) {
+        for (Neighbor nb : g.neighbors(u)) {
+            if (g.isDirected() || u <= nb.v) edges.push_back(Edge(rank[u], rank[nb.v], nb.w));
+        }
+    }
+    return CSRGraph::fromEdges(n, edges, g.isDirected());
+}
+
+// 字符标签层DFS（保持原有接口，邻居按标签顺序访问）
+vector<char> DFS(Graph& graph, char start) {
+    struct OrderVisitor : DFSVisitor {
+        vector<VertexId> order;
+        void discover(VertexId v) { order.push_back(v); }
+    };
+    OrderVisitor vis;
+    vector<char> result;
+    if (is_sorted(graph.idxToVertex.begin(), graph.idxToVertex.end(), [](char a, char b) {
+            return (unsigned char)a < (unsigned char)b;
+        })) {
+        DFSEngine dfs(graph.csr());
+        dfs.run(graph.id(start), vis);
+        for (VertexId v : vis.order) result.push_back(graph.label(v));
+        return result;
+    }
+    vector<VertexId> byRank;
+    CSRGraph g = labelOrderedCSR(graph, byRank);
+    VertexId s = find(byRank.begin(), byRank.end(), graph.id(start)) - byRank.begin();
+    DFSEngine dfs(g);
+    dfs.run(s, vis);
+    for (VertexId r : vis.order) result.push_back(graph.label(byRank[r]));
+    return result;
+}
+
+// 字符标签层拓扑排序（有向图，存在环时抛出异常）
+vector<char> topologicalSort(Graph& graph) {
+    vector<VertexId> order;
+    if (!topologicalSort(graph.csr(), order)) throw runtime_error("图中存在环，无法拓扑排序");
+    vector<char> result;
+    for (VertexId v : order) result.push_back(graph.label(v));
+    return result;
+}
+
+// ============================== 任务3：最短路径（Dijkstra）和最小支撑树（Prim） ==============================
+typedef long long Dist;               // 路径长度（64位，避免int累加溢出）
+const Dist INF_DIST = LLONG_MAX;     // 不可达
+
+// d叉堆（惰性删除：同一顶点可多次入堆，出堆时跳过过期项）；D=2即二叉堆
+template <int D>
+class DaryHeap {
+private:
+    vector<pair<Dist, VertexId>> h;
+
+public:
+    bool empty() const { return h.empty(); }
+    size_t size() const { return h.size(); }
+    void clear() { h.clear(); }
+
+    const pair<Dist, VertexId>& top() const { return h[0]; }
+
+    void push(Dist key, VertexId v) {
+        size_t i = h.size();
+        h.emplace_back(key, v);
+        while (i > 0) {
+            size_t p = (i - 1) / D;
+            if (!(h[i] < h[p])) break;
+            swap(h[i], h[p]);
+            i = p;
+        }
+    }
+
+    pair<Dist, VertexId> pop() {
+        pair<Dist, VertexId> top = h[0];
+        h[0] = h.back();
+        h.pop_back();
+        size_t i = 0, n = h.size();
+        while (true) {
+            size_t first = D * i + 1;
+            if (first >= n) break;
+            size_t best = first;
+            size_t last = min(first + D, n);
+            for (size_t c = first + 1; c < last; ++c) {
+                if (h[c] < h[best]) best = c;
+            }
+            if (!(h[best] < h[i])) break;
+            swap(h[i], h[best]);
+            i = best;
+        }
+        return top;
+    }
+};
+
+typedef DaryHeap<2> BinaryHeap;
+typedef DaryHeap<4> QuaternaryHeap;
+
+// 基数堆：只适用于单调出堆的非负整数键（Dijkstra满足），均摊 O(log C)
+class RadixHeap {
+private:
+    vector<pair<Dist, VertexId>> buckets[65];
+    Dist last;   // 最近一次出堆的键
+    size_t cnt;
+
+    static int bucketOf(Dist key, Dist last) {
+        unsigned long long x = (unsigned long long)key ^ (unsigned long long)last;
+        return x == 0 ? 0 : 64 - __builtin_clzll(x);
+    }
+
+public:
+    RadixHeap() : last(0), cnt(0) {}
+
+    bool empty() const { return cnt == 0; }
+    size_t size() const { return cnt; }
+
+    void clear() {
+        for (auto& b : buckets) b.clear();
+        last = 0;
+        cnt = 0;
+    }
+
+    void push(Dist key, VertexId v) {
+        buckets[bucketOf(key, last)].emplace_back(key, v);
+        cnt++;
+    }
+
+    // 桶0为空时，把最小非空桶按新的last重新分配（桶0中的键都等于last）
+    void refill() {
+        if (!buckets[0].empty()) return;
+        int i = 1;
+        while (buckets[i].empty()) i++;
+        Dist newLast = buckets[i][0].first;
+        for (auto& e : buckets[i]) newLast = min(newLast, e.first);
+        last = newLast;
+        for (auto& e : buckets[i]) buckets[bucketOf(e.first, last)].push_back(e);
+        buckets[i].clear();
+    }
+
+    pair<Dist, VertexId> top() {
+        refill();
+        return buckets[0].back();
+    }
+
+    pair<Dist, VertexId> pop() {
+        refill();
+        pair<Dist, VertexId> top = buckets[0].back();
+        buckets[0].pop_back();
+        cnt--;
+        return top;
+    }
+};
+
+// 可选的堆实现
+enum class HeapKind { Binary, Quaternary, Radix };
+
+// 最短路查询工作区：按顶点编号索引的平坦数组，记录被修改过的顶点，重置代价为 O(被触及的顶点数)
+struct SPWorkspace {
+    vector<Dist> dist;
+    vector<VertexId> prev;
+    vector<VertexId> touched;
+
+    void ensure(int n) {
+        if ((int)dist.size() < n) {
+            dist.resize(n, INF_DIST);
+            prev.resize(n, -1);
+        }
+    }
+
+    void reset() {
+        for (VertexId v : touched) {
+            dist[v] = INF_DIST;
+            prev[v] = -1;
+        }
+        touched.clear();
+    }
+
+    // 松弛：dist[v]变小时返回true
+    bool relax(VertexId v, Dist d, VertexId from) {
+        if (d >= dist[v]) return false;
+        if (dist[v] == INF_DIST) touched.push_back(v);
+        dist[v] = d;
+        prev[v] = from;
+        return true;
+    }
+};
+
+// Dijkstra引擎：绑定一张CSR图，工作区和堆在多次查询之间复用
+template <typename Heap>
+class DijkstraEngine {
+private:
+    const CSRGraph& g;
+    SPWorkspace ws;
+    Heap heap;
+    int settled; // 上次查询出堆（确定距离）的顶点数
+
+public:
+    DijkstraEngine(const CSRGraph& graph) : g(graph), settled(0) {
+        for (VertexId u = 0; u < g.numVertices(); ++u) {
+            for (Neighbor nb : g.neighbors(u)) {
+                if (nb.w < 0) throw invalid_argument("Dijkstra不支持负权边");
+            }
+        }
+        ws.ensure(g.numVertices());
+    }
+
+    // 从source出发求最短路；给定target时到达即提前结束，返回source到target的距离
+    Dist run(VertexId source, VertexId target = -1) {
+        PERF_SCOPE("esp3_dijkstra");
+        ws.reset();
+        heap.clear();
+        settled = 0;
+        ws.relax(source, 0, -1);
+        heap.push(0, source);
+
+        while (!heap.empty()) {
+            pair<Dist, VertexId> top = heap.pop();
+            Dist d = top.first;
+            VertexId u = top.second;
+            if (d > ws.dist[u]) continue; // 过期项
+            settled++;
+            if (u == target) break;
+            for (Neighbor nb : g.neighbors(u)) {
+                if (ws.relax(nb.v, d + nb.w, u)) heap.push(d + nb.w, nb.v);
+            }
+        }
+        PERF_COUNT("esp3_dijkstra_settled", settled);
+        return target >= 0 ? ws.dist[target] : 0;
+    }
+
+    Dist distance(VertexId v) const { return ws.dist[v]; }
+    VertexId parent(VertexId v) const { return ws.prev[v]; }
+    int settledCount() const { return settled; }
+
+    // 从最短路树中回溯到target的路径（不可达时为空）
+    vector<VertexId> path(VertexId target) const {
+        vector<VertexId> p;
+        if (ws.dist[target] == INF_DIST) return p;
+        for (VertexId v = target; v != -1; v = ws.prev[v]) p.push_back(v);
+        reverse(p.begin(), p.end());
+        return p;
+    }
+};
+
+// 按指定堆实现做一次点对点查询，返回距离并填写路径
+Dist shortestPath(const CSRGraph& g, VertexId s, VertexId t, vector<VertexId>& path, HeapKind kind = HeapKind::Binary) {
+    switch (kind) {
+        case HeapKind::Quaternary: {
+            DijkstraEngine<QuaternaryHeap> engine(g);
+            Dist d = engine.run(s, t);
+            path = engine.path(t);
+            return d;
+        }
+        case HeapKind::Radix: {
+            DijkstraEngine<RadixHeap> engine(g);
+            Dist d = engine.run(s, t);
+            path = engine.path(t);
+            return d;
+        }
+        default: {
+            DijkstraEngine<BinaryHeap> engine(g);
+            Dist d = engine.run(s, t);
+            path = engine.path(t);
+            return d;
+        }
+    }
+}
+
+// 字符标签层的一对多Dijkstra（保持原有接口，距离改为64位）
+pair<map<char, Dist>, map<char, char>> Dijkstra(Graph& graph, char start) {
+    DijkstraEngine<BinaryHeap> engine(graph.csr());
+    engine.run(graph.id(start));
+
+    map<char, Dist> dist;
+    map<char, char> prev;
+    for (VertexId v = 0; v < graph.numVertices(); ++v) {
+        char label = graph.label(v);
+        dist[label] = engine.distance(v);
+        prev[label] = engine.parent(v) >= 0 ? graph.label(engine.parent(v)) : '\0';
+    }
+    return make_pair(dist, prev);
+}
+
+void printDijkstraPath(map<char, char>& prev, char start, char target) {
+    vector<char> path;
+    for (char v = target; v != '\0'; v = prev[v]) {
+        path.push_back(v);
+    }
+    reverse(path.begin(), path.end());
+
+    cout << "路径 " << start << "->" << target << "：";
+    if (path[0] != start) {
+        cout << "无\n";
+        return;
+    }
+    for (int i = 0; i < path.size(); ++i) {
+        if (i > 0) cout << "->";
+        cout << path[i];
+    }
+    cout << "\n";
+}
+
+// ============================== 点对点最短路：双向Dijkstra与A* ==============================
+// 点对点查询结果：直接给出路径
+struct PathResult {
+    Dist dist;               // 最短距离（INF_DIST表示不可达）
+    vector<VertexId> path;   // 路径上的顶点（不可达时为空）
+    int settled;             // 出堆（确定距离）的顶点数，衡量搜索空间
+};
+
+// 双向Dijkstra：从起点正向、从终点在反向图上同时搜索，两侧堆顶之和不小于当前最优值时停止
+template <typename Heap = BinaryHeap>
+class BidirectionalDijkstra {
+private:
+    const CSRGraph& fwd;
+    CSRGraph reverseGraph;   // 有向图的反向图（无向图不需要）
+    const CSRGraph* bwd;
+    SPWorkspace wsF, wsB;
+    Heap heapF, heapB;
+
+public:
+    BidirectionalDijkstra(const CSRGraph& g) : fwd(g), bwd(&g) {
+        if (g.isDirected()) {
+            reverseGraph = g.reversed();
+            bwd = &reverseGraph;
+        }
+        wsF.ensure(g.numVertices());
+        wsB.ensure(g.numVertices());
+    }
+
+    PathResult query(VertexId s, VertexId t) {
+        wsF.reset(); wsB.reset();
+        heapF.clear(); heapB.clear();
+        PathResult res{INF_DIST, {}, 0};
+
+        wsF.relax(s, 0, -1); heapF.push(0, s);
+        wsB.relax(t, 0, -1); heapB.push(0, t);
+        Dist best = s == t ? 0 : INF_DIST;
+        VertexId meet = s == t ? s : -1;
+
+        while (!heapF.empty() && !heapB.empty()) {
+            Dist topF = heapF.top().first, topB = heapB.top().first;
+            if (best != INF_DIST && topF + topB >= best) break;
+
+            // 扩展堆顶较小的一侧
+            bool forward = topF <= topB;
+            Heap& heap = forward ? heapF : heapB;
+            SPWorkspace& ws = forward ? wsF : wsB;
+            const SPWorkspace& other = forward ? wsB : wsF;
+            const CSRGraph& g = forward ? fwd : *bwd;
+
+            pair<Dist, VertexId> top = heap.pop();
+            Dist d = top.first;
+            VertexId u = top.second;
+            if (d > ws.dist[u]) continue;
+            res.settled++;
+            for (Neighbor nb : g.neighbors(u)) {
+                Dist nd = d + nb.w;
+                if (ws.relax(nb.v, nd, u)) heap.push(nd, nb.v);
+                if (other.dist[nb.v] != INF_DIST && nd + other.dist[nb.v] < best) {
+                    best = nd + other.dist[nb.v];
+                    meet = nb.v;
+                }
+            }
+        }
+
+        res.dist = best;
+        if (meet >= 0) {
+            for (VertexId v = meet; v != -1; v = wsF.prev[v]) res.path.push_back(v);
+            reverse(res.path.begin(), res.path.end());
+            for (VertexId v = wsB.prev[meet]; v != -1; v = wsB.prev[v]) res.path.push_back(v);
+        }
+        return res;
+    }
+};
+
+// 零启发函数：A*退化为Dijkstra
+struct ZeroHeuristic {
+    Dist operator()(VertexId, VertexId) const { return 0; }
+};
+
+// 坐标启发函数：要求每条边的权重 >= scale × 两端点的欧氏距离，此时 scale × 欧氏距离 为相容下界
+struct EuclideanHeuristic {
+    const vector<double>& x;
+    const vector<double>& y;
+    double scale;
+
+    EuclideanHeuristic(const vector<double>& xs, const vector<double>& ys, double s) : x(xs), y(ys), scale(s) {}
+
+    Dist operator()(VertexId v, VertexId t) const {
+        return (Dist)(scale * hypot(x[v] - x[t], y[v] - y[t]));
+    }
+};
+
+// 地标启发函数（ALT）：预先求出若干地标到各顶点（及各顶点到地标）的距离，
+// 由三角不等式 d(v,t) >= d(L,t) - d(L,v) 与 d(v,t) >= d(v,L) - d(t,L) 取最大值作为下界
+class LandmarkHeuristic {
+private:
+    int n;
+    vector<VertexId> landmarks;
+    vector<Dist> from;   // from[i*n+v] = d(L_i, v)
+    vector<Dist> to;     // to[i*n+v]   = d(v, L_i)（无向图与from相同，不单独存储）
+    bool directed;
+
+public:
+    // 地标选择：从顶点0出发，每次选取距已有地标最远的可达顶点（farthest selection）
+    LandmarkHeuristic(const CSRGraph& g, int k) : n(g.numVertices()), directed(g.isDirected()) {
+        if (n == 0) return;
+        DijkstraEngine<BinaryHeap> engine(g);
+        CSRGraph rev;
+        if (directed) rev = g.reversed();
+        vector<Dist> nearest(n, INF_DIST);
+        VertexId next = 0;
+        for (int i = 0; i < k; ++i) {
+            landmarks.push_back(next);
+            engine.run(next);
+            for (VertexId v = 0; v < n; ++v) {
+                Dist d = engine.distance(v);
+                from.push_back(d);
+                if (d != INF_DIST) nearest[v] = min(nearest[v], d);
+            }
+            if (directed) {
+                DijkstraEngine<BinaryHeap> back(rev);
+                back.run(next);
+                for (VertexId v = 0; v < n; ++v) to.push_back(back.distance(v));
+            }
+            VertexId far = -1;
+            for (VertexId v = 0; v < n; ++v) {
+                if (nearest[v] != INF_DIST && nearest[v] > 0 && (far < 0 || nearest[v] > nearest[far])) far = v;
+            }
+            if (far < 0) break;
+            next = far;
+        }
+    }
+
+    const vector<VertexId>& getLandmarks() const {
+        return landmarks;
+    }
+
+    Dist operator()(VertexId v, VertexId t) const {
+        const vector<Dist>& toL = directed ? to : from;
+        Dist h = 0;
+        for (size_t i = 0; i < landmarks.size(); ++i) {
+            const Dist* f = &from[i * n];
+            const Dist* b = &toL[i * n];
+            if (f[t] != INF_DIST && f[v] != INF_DIST) h = max(h, f[t] - f[v]);
+            if (b[v] != INF_DIST && b[t] != INF_DIST) h = max(h, b[v] - b[t]);
+        }
+        return h;
+    }
+};
+
+// A*搜索：键为 g(v) + h(v,t)；启发函数可采纳即可得到最优解（不相容时允许顶点重新打开），
+// 基数堆要求键单调，只能配合相容的启发函数使用
+template <typename Heuristic, typename Heap = BinaryHeap>
+class AStarEngine {
+private:
+    const CSRGraph& g;
+    const Heuristic& h;
+    SPWorkspace ws;
+    Heap heap;
+
+public:
+    AStarEngine(const CSRGraph& graph, const Heuristic& heuristic) : g(graph), h(heuristic) {
+        ws.ensure(g.numVertices());
+    }
+
+    PathResult query(VertexId s, VertexId t) {
+        ws.reset();
+        heap.clear();
+        PathResult res{INF_DIST, {}, 0};
+
+        ws.relax(s, 0, -1);
+        heap.push(h(s, t), s);
+        while (!heap.empty()) {
+            pair<Dist, VertexId> top = heap.pop();
+            VertexId u = top.second;
+            Dist d = ws.dist[u];
+            if (top.first > d + h(u, t)) continue; // 过期项
+            res.settled++;
+            if (u == t) break;
+            for (Neighbor nb : g.neighbors(u)) {
+                Dist nd = d + nb.w;
+                if (ws.relax(nb.v, nd, u)) heap.push(nd + h(nb.v, t), nb.v);
+            }
+        }
+
+        res.dist = ws.dist[t];
+        if (res.dist != INF_DIST) {
+            for (VertexId v = t; v != -1; v = ws.prev[v]) res.path.push_back(v);
+            reverse(res.path.begin(), res.path.end());
+        }
+        return res;
+    }
+};
+
+// ============================== 收缩层次（Contraction Hierarchies） ==============================
+// 预处理：按重要度依次收缩顶点，收缩v时若 u->v->x 是u到x的唯一最短路（见证搜索找不到更短的替代路径），
+// 则插入捷径 u->x。查询时只需沿"等级升高"的弧做双向搜索，再把捷径递归展开为原图路径。
+class ContractionHierarchy {
+private:
+    // 收缩过程中的动态弧
+    struct DynArc {
+        VertexId to;
+        Dist w;
+        VertexId mid; // 捷径的中间顶点（原图弧为-1）
+    };
+
+    int n = 0;
+    vector<int> rankOf;                       // 收缩次序（等级）
+    // 上行图：fwd[u]存 u->x（rank[x]>rank[u]）；bwd[x]存 u->x 中的u（rank[u]>rank[x]）
+    vector<EdgeId> fOff, bOff;
+    vector<VertexId> fTgt, bSrc, fMid, bMid;
+    vector<Dist> fW, bW;
+    EdgeId shortcuts = 0;
+
+    friend class CHQuery;
+
+    // 见证搜索：在剩余图中从u出发（跳过v）做受限Dijkstra，dist写入ws；
+    // 超过距离上限、出堆数上限，或v的出邻居都已确定距离时提前结束
+    static void witnessSearch(const vector<vector<DynArc>>& out, VertexId u, VertexId v, Dist limit,
+                              int settleLimit, SPWorkspace& ws, BinaryHeap& heap,
+                              vector<int>& mark, int stamp, int targets) {
+        ws.reset();
+        heap.clear();
+        ws.relax(u, 0, -1);
+        heap.push(0, u);
+        int settled = 0;
+        while (!heap.empty() && targets > 0) {
+            pair<Dist, VertexId> top = heap.pop();
+            if (top.first > ws.dist[top.second]) continue;
+            if (top.first > limit || ++settled > settleLimit) break;
+            if (mark[top.second] == stamp) targets--;
+            for (const DynArc& a : out[top.second]) {
+                if (a.to == v) continue;
+                if (ws.relax(a.to, top.first + a.w, top.second)) heap.push(top.first + a.w, a.to);
+            }
+        }
+    }
+
+    // 收缩v需要的捷径（simulate为true时只计数）
+    static int contractNode(vector<vector<DynArc>>& out, vector<vector<DynArc>>& in, VertexId v, bool simulate,
+                            int settleLimit, SPWorkspace& ws, BinaryHeap& heap, vector<int>& mark, int& stamp) {
+        Dist maxOut = 0;
+        for (const DynArc& a : out[v]) maxOut = max(maxOut, a.w);
+        int added = 0;
+        vector<DynArc> inArcs = in[v];
+        for (const DynArc& ia : inArcs) {
+            VertexId u = ia.to;
+            if (u == v) continue;
+            stamp++;
+            int targets = 0;
+            for (const DynArc& oa : out[v]) {
+                if (oa.to != u && mark[oa.to] != stamp) {
+                    mark[oa.to] = stamp;
+                    targets++;
+                }
+            }
+            witnessSearch(out, u, v, ia.w + maxOut, settleLimit, ws, heap, mark, stamp, targets);
+            for (const DynArc& oa : out[v]) {
+                VertexId x = oa.to;
+                if (x == u || x == v) continue;
+                Dist via = ia.w + oa.w;
+                if (ws.dist[x] <= via) continue; // 找到见证路径，无需捷径
+                added++;
+                if (!simulate) addArc(out, in, u, x, via, v);
+            }
+        }
+        return added;
+    }
+
+    // 插入（或以更小权重更新）弧 u->x
+    static void addArc(vector<vector<DynArc>>& out, vector<vector<DynArc>>& in, VertexId u, VertexId x, Dist w, VertexId mid) {
+        for (DynArc& a : out[u]) {
+            if (a.to == x) {
+                if (w < a.w) {
+                    a.w = w;
+                    a.mid = mid;
+                    for (DynArc& b : in[x]) {
+                        if (b.to == u) { b.w = w; b.mid = mid; break; }
+                    }
+                }
+                return;
+            }
+        }
+        out[u].push_back(DynArc{x, w, mid});
+        in[x].push_back(DynArc{u, w, mid});
+    }
+
+    static void removeArc(vector<DynArc>& list, VertexId to) {
+        for (size_t i = 0; i < list.size(); ++i) {
+            if (list[i].to == to) {
+                list[i] = list.back();
+                list.pop_back();
+                return;
+            }
+        }
+    }
+
+    // 查找弧 a->b 的权重和中间顶点（a、b必须有弧相连）
+    pair<Dist, VertexId> arcInfo(VertexId a, VertexId b) const {
+        if (rankOf[a] < rankOf[b]) {
+            for (EdgeId e = fOff[a]; e < fOff[a + 1]; ++e) {
+                if (fTgt[e] == b) return make_pair(fW[e], fMid[e]);
+            }
+        } else {
+            for (EdgeId e = bOff[b]; e < bOff[b + 1]; ++e) {
+                if (bSrc[e] == a) return make_pair(bW[e], bMid[e]);
+            }
+        }
+        throw logic_error("CH中不存在该弧");
+    }
+
+    template <typename T>
+    static void writeArray(FILE* fp, const vector<T>& v) {
+        unsigned long long cnt = v.size();
+        fwrite(&cnt, sizeof(cnt), 1, fp);
+        if (cnt > 0) fwrite(v.data(), sizeof(T), cnt, fp);
+    }
+
+    // remain为文件剩余字节数，长度前缀超过它说明文件被截断或损坏，不按它分配内存
+    template <typename T>
+    static void readArray(FILE* fp, vector<T>& v, unsigned long long& remain) {
+        unsigned long long cnt = 0;
+        if (remain < sizeof(cnt) || fread(&cnt, sizeof(cnt), 1, fp) != 1) throw runtime_error("CH文件不完整");
+        remain -= sizeof(cnt);
+        if (cnt > remain / sizeof(T)) throw runtime_error("CH文件不完整");
+        remain -= cnt * sizeof(T);
+        v.resize(cnt);
+        if (cnt > 0 && fread(v.data(), sizeof(T), cnt, fp) != cnt) throw runtime_error("CH文件不完整");
+    }
+
+public:
+    // 预处理：优先级 = 捷径数 - 删除的弧数 + 已收缩的邻居数，出堆时重新计算（惰性更新）
+    static ContractionHierarchy build(const CSRGraph& g, int settleLimit = 500) {
+        ContractionHierarchy ch;
+        int n = ch.n = g.numVertices();
+        vector<vector<DynArc>> out(n), in(n);
+        for (VertexId u = 0; u < n; ++u) {
+            for (Neighbor nb : g.neighbors(u)) {
+                if (nb.v != u) addArc(out, in, u, nb.v, nb.w, -1);
+            }
+        }
+
+        SPWorkspace ws;
+        ws.ensure(n);
+        BinaryHeap heap;
+        vector<int> deletedNeighbors(n, 0);
+        vector<int> mark(n, 0); // 见证搜索的目标标记（按stamp区分各次搜索）
+        int stamp = 0;
+        auto priority = [&](VertexId v) {
+            int sc = contractNode(out, in, v, true, min(settleLimit, 50), ws, heap, mark, stamp); // 估算时用更小的搜索上限
+            return (long long)sc - (long long)(in[v].size() + out[v].size()) + deletedNeighbors[v];
+        };
+        // 堆中同一顶点可能有多个项，只有与curPrio一致的项有效
+        priority_queue<pair<long long, VertexId>, vector<pair<long long, VertexId>>, greater<pair<long long, VertexId>>> order;
+        vector<long long> curPrio(n);
+        for (VertexId v = 0; v < n; ++v) {
+            curPrio[v] = priority(v);
+            order.push(make_pair(curPrio[v], v));
+        }
+
+        ch.rankOf.assign(n, -1);
+        vector<vector<DynArc>> upF(n), upB(n);
+        vector<VertexId> neighbors;
+        int nextRank = 0;
+        while (!order.empty()) {
+            pair<long long, VertexId> top = order.top();
+            order.pop();
+            VertexId v = top.second;
+            if (ch.rankOf[v] >= 0 || top.first != curPrio[v]) continue;
+            long long p = priority(v);
+            if (!order.empty() && p > order.top().first) {
+                curPrio[v] = p;
+                order.push(make_pair(p, v));
+                continue;
+            }
+
+            ch.rankOf[v] = nextRank++;
+            ch.shortcuts += contractNode(out, in, v, false, settleLimit, ws, heap, mark, stamp);
+            // v的剩余弧都通向等级更高的顶点，定稿为上行弧，并从邻居的弧表中删除
+            upF[v] = out[v];
+            upB[v] = in[v];
+            neighbors.clear();
+            for (const DynArc& a : out[v]) { removeArc(in[a.to], v); neighbors.push_back(a.to); }
+            for (const DynArc& a : in[v]) { removeArc(out[a.to], v); neighbors.push_back(a.to); }
+            vector<DynArc>().swap(out[v]);
+            vector<DynArc>().swap(in[v]);
+
+            // 邻居的优先级随之变化，立即重新计算
+            sort(neighbors.begin(), neighbors.end());
+            neighbors.erase(unique(neighbors.begin(), neighbors.end()), neighbors.end());
+            for (VertexId x : neighbors) {
+                deletedNeighbors[x]++;
+                curPrio[x] = priority(x);
+                order.push(make_pair(curPrio[x], x));
+            }
+        }
+
+        // 转为平坦数组
+        auto flatten = [n](const vector<vector<DynArc>>& lists, vector<EdgeId>& off, vector<VertexId>& tgt,
+                           vector<Dist>& w, vector<VertexId>& mid) {
+            off.assign(n + 1, 0);
+            for (int v = 0; v < n; ++v) off[v + 1] = off[v] + lists[v].size();
+            tgt.resize(off[n]); w.resize(off[n]); mid.resize(off[n]);
+            for (int v = 0; v < n; ++v) {
+                EdgeId p = off[v];
+                for (const DynArc& a : lists[v]) {
+                    tgt[p] = a.to; w[p] = a.w; mid[p] = a.mid;
+                    p++;
+                }
+            }
+        };
+        flatten(upF, ch.fOff, ch.fTgt, ch.fW, ch.fMid);
+        flatten(upB, ch.bOff, ch.bSrc, ch.bW, ch.bMid);
+        return ch;
+    }
+
+    int numVertices() const { return n; }
+    EdgeId numShortcuts() const { return shortcuts; }
+    EdgeId numArcs() const { return fTgt.size() + bSrc.size(); }
+
+    // 二进制存盘：魔数 + 顶点数 + 各数组（长度前缀 + 原始字节）
+    void save(const string& path) const {
+        FILE* fp = fopen(path.c_str(), "wb");
+        if (!fp) throw runtime_error("无法写入文件: " + path);
+        fwrite("CH01", 1, 4, fp);
+        fwrite(&n, sizeof(n), 1, fp);
+        fwrite(&shortcuts, sizeof(shortcuts), 1, fp);
+        writeArray(fp, rankOf);
+        writeArray(fp, fOff); writeArray(fp, fTgt); writeArray(fp, fW); writeArray(fp, fMid);
+        writeArray(fp, bOff); writeArray(fp, bSrc); writeArray(fp, bW); writeArray(fp, bMid);
+        bool ok = ferror(fp) == 0;
+        fclose(fp);
+        if (!ok) throw runtime_error("写入CH文件失败: " + path);
+    }
+
+    // 读盘：按顺序整块读入各数组
+    static ContractionHierarchy load(const string& path) {
+        FILE* fp = fopen(path.c_str(), "rb");
+        if (!fp) throw runtime_error("无法打开文件: " + path);
+        ContractionHierarchy ch;
+        try {
+            char magic[4];
+            if (fread(magic, 1, 4, fp) != 4 || memcmp(magic, "CH01", 4) != 0) throw runtime_error("不是CH文件: " + path);
+            if (fread(&ch.n, sizeof(ch.n), 1, fp) != 1 || fread(&ch.shortcuts, sizeof(ch.shortcuts), 1, fp) != 1) {
+                throw runtime_error("CH文件不完整");
+            }
+            long here = ftell(fp);
+            fseek(fp, 0, SEEK_END);
+            unsigned long long remain = ftell(fp) - here;
+            fseek(fp, here, SEEK_SET);
+            readArray(fp, ch.rankOf, remain);
+            readArray(fp, ch.fOff, remain); readArray(fp, ch.fTgt, remain); readArray(fp, ch.fW, remain); readArray(fp, ch.fMid, remain);
+            readArray(fp, ch.bOff, remain); readArray(fp, ch.bSrc, remain); readArray(fp, ch.bW, remain); readArray(fp, ch.bMid, remain);
+        } catch (...) {
+            fclose(fp);
+            throw;
+        }
+        fclose(fp);
+        if (!ch.isConsistent()) throw runtime_error("CH文件损坏: " + path);
+        return ch;
+    }
+
+    // 结构校验（读盘后调用）：数组长度与offsets一致且单调，等级是0~n-1的排列，
+    // 上行弧指向等级更高的顶点，捷径中间点的等级低于弧的起点（保证unpack有限步结束）
+    bool isConsistent() const {
+        if (n < 0 || (long long)rankOf.size() != n) return false;
+        vector<char> seen(n, 0);
+        for (int r : rankOf) {
+            if (r < 0 || r >= n || seen[r]) return false;
+            seen[r] = 1;
+        }
+        auto arcsOk = [&](const vector<EdgeId>& off, const vector<VertexId>& end, const vector<Dist>& w,
+                          const vector<VertexId>& mid) {
+            if ((long long)off.size() != n + 1 || off[0] != 0 || (size_t)off[n] != end.size() ||
+                w.size() != end.size() || mid.size() != end.size()) {
+                return false;
+            }
+            for (int v = 0; v < n; ++v) {
+                if (off[v + 1] < off[v]) return false;
+                for (EdgeId e = off[v]; e < off[v + 1]; ++e) {
+                    VertexId x = end[e], m = mid[e];
+                    if (x < 0 || x >= n || rankOf[x] <= rankOf[v]) return false;
+                    if (m != -1 && (m < 0 || m >= n || rankOf[m] >= rankOf[v])) return false;
+                }
+            }
+            return true;
+        };
+        return arcsOk(fOff, fTgt, fW, fMid) && arcsOk(bOff, bSrc, bW, bMid);
+    }
+
+    // 把弧序列（CH中的路径）展开为原图路径，显式栈代替递归
+    void unpack(const vector<VertexId>& chPath, vector<VertexId>& path) const {
+        path.clear();
+        if (chPath.empty()) return;
+        path.push_back(chPath[0]);
+        vector<pair<VertexId, VertexId>> stk;
+        for (size_t i = 0; i + 1 < chPath.size(); ++i) {
+            stk.push_back(make_pair(chPath[i], chPath[i + 1]));
+            while (!stk.empty()) {
+                pair<VertexId, VertexId> arc = stk.back();
+                stk.pop_back();
+                VertexId mid = arcInfo(arc.first, arc.second).second;
+                if (mid < 0) {
+                    path.push_back(arc.second);
+                } else {
+                    stk.push_back(make_pair(mid, arc.second));
+                    stk.push_back(make_pair(arc.first, mid));
+                }
+            }
+        }
+    }
+};
+
+// CH查询：正向沿fwd、反向沿bwd做只升不降的双向Dijkstra，带stall-on-demand剪枝
+class CHQuery {
+private:
+    const ContractionHierarchy& ch;
+    SPWorkspace wsF, wsB;
+    BinaryHeap heapF, heapB;
+
+public:
+    CHQuery(const ContractionHierarchy& h) : ch(h) {
+        wsF.ensure(h.n);
+        wsB.ensure(h.n);
+    }
+
+    PathResult query(VertexId s, VertexId t, bool wantPath = true) {
+        wsF.reset(); wsB.reset();
+        heapF.clear(); heapB.clear();
+        PathResult res{INF_DIST, {}, 0};
+        wsF.relax(s, 0, -1); heapF.push(0, s);
+        wsB.relax(t, 0, -1); heapB.push(0, t);
+        Dist best = INF_DIST;
+        VertexId meet = -1;
+
+        bool forward = true;
+        while (!heapF.empty() || !heapB.empty()) {
+            // 某一侧堆顶已不小于当前最优值时，该侧停止
+            if (!heapF.empty() && heapF.top().first >= best) heapF.clear();
+            if (!heapB.empty() && heapB.top().first >= best) heapB.clear();
+            if (heapF.empty() && heapB.empty()) break;
+            if (heapF.empty()) forward = false;
+            else if (heapB.empty()) forward = true;
+
+            bool isF = forward;
+            forward = !forward;
+            BinaryHeap& heap = isF ? heapF : heapB;
+            SPWorkspace& ws = isF ? wsF : wsB;
+            const SPWorkspace& other = isF ? wsB : wsF;
+            pair<Dist, VertexId> top = heap.pop();
+            Dist d = top.first;
+            VertexId u = top.second;
+            if (d > ws.dist[u]) continue;
+            res.settled++;
+            if (other.dist[u] != INF_DIST && d + other.dist[u] < best) {
+                best = d + other.dist[u];
+                meet = u;
+            }
+
+            // 正向沿fwd扩展、用bwd检查stall；反向相反
+            const vector<EdgeId>& off = isF ? ch.fOff : ch.bOff;
+            const vector<VertexId>& tgt = isF ? ch.fTgt : ch.bSrc;
+            const vector<Dist>& w = isF ? ch.fW : ch.bW;
+            const vector<EdgeId>& sOff = isF ? ch.bOff : ch.fOff;
+            const vector<VertexId>& sTgt = isF ? ch.bSrc : ch.fTgt;
+            const vector<Dist>& sW = isF ? ch.bW : ch.fW;
+            // stall-on-demand：若经由某个更高等级的顶点到达u更短，则u不必继续扩展
+            bool stalled = false;
+            for (EdgeId e = sOff[u]; e < sOff[u + 1]; ++e) {
+                Dist dw = ws.dist[sTgt[e]];
+                if (dw != INF_DIST && dw + sW[e] < d) { stalled = true; break; }
+            }
+            if (stalled) continue;
+
+            for (EdgeId e = off[u]; e < off[u + 1]; ++e) {
+                Dist nd = d + w[e];
+                if (ws.relax(tgt[e], nd, u)) heap.push(nd, tgt[e]);
+            }
+        }
+
+        res.dist = best;
+        if (meet >= 0 && wantPath) {
+            vector<VertexId> chPath;
+            for (VertexId v = meet; v != -1; v = wsF.prev[v]) chPath.push_back(v);
+            reverse(chPath.begin(), chPath.end());
+            for (VertexId v = wsB.prev[meet]; v != -1; v = wsB.prev[v]) chPath.push_back(v);
+            ch.unpack(chPath, res.path);
+        }
+        return res;
+    }
+};
+
+// ============================== 并行最短路：delta-stepping 与多源批量 ==============================
+// delta-stepping：按 dist/delta 分桶，同一桶内的顶点可并行松弛；
+// 权重 <= delta 的轻边可能把顶点放回当前桶，需反复处理直到桶空，重边在桶清空后统一松弛一次
+class DeltaStepping {
+private:
+    const CSRGraph& g;
+    ThreadPool& pool;
+    Dist delta;
+    unique_ptr<atomic<Dist>[]> dist;
+    vector<int> stamp;                    // 去重标记
+    int curStamp;
+    vector<vector<VertexId>> requests;    // 每个分块产生的"距离变小"的顶点
+    map<Dist, vector<VertexId>> buckets;  // 桶号 -> 顶点（可能含过期项）
+    int chunks;
+
+    // 原子地取最小值，距离变小时返回true
+    bool relaxAtomic(VertexId v, Dist nd) {
+        Dist cur = dist[v].load(memory_order_relaxed);
+        while (nd < cur) {
+            if (dist[v].compare_exchange_weak(cur, nd, memory_order_relaxed)) return true;
+        }
+        return false;
+    }
+
+    // 并行松弛frontier中顶点的轻边（light=true）或重边，结果先写入各分块的请求表，再串行入桶
+    void relaxEdges(const vector<VertexId>& frontier, bool light) {
+        int c = frontier.size() < 1024 ? 1 : chunks; // 小frontier串行，省去调度开销
+        for (int i = 0; i < c; ++i) requests[i].clear();
+        parallelFor(pool, frontier.size(), c, [&](size_t b, size_t e, int chunk) {
+            vector<VertexId>& req = requests[chunk];
+            for (size_t i = b; i < e; ++i) {
+                VertexId u = frontier[i];
+                Dist du = dist[u].load(memory_order_relaxed);
+                for (Neighbor nb : g.neighbors(u)) {
+                    if ((nb.w <= delta) != light) continue;
+                    if (relaxAtomic(nb.v, du + nb.w)) req.push_back(nb.v);
+                }
+            }
+        });
+        for (int i = 0; i < c; ++i) {
+            for (VertexId v : requests[i]) {
+                buckets[dist[v].load(memory_order_relaxed) / delta].push_back(v);
+            }
+        }
+    }
+
+public:
+    DeltaStepping(const CSRGraph& graph, ThreadPool& tp, Dist d = 0)
+        : g(graph), pool(tp), delta(d), dist(new atomic<Dist>[graph.numVertices()]),
+          stamp(graph.numVertices(), 0), curStamp(0), chunks(4 * tp.size()) {
+        requests.resize(chunks);
+        // 无论是否显式给定delta都要拒绝负权边；同一遍累计边权，未给定delta时默认取平均边权
+        long long sum = 0;
+        for (VertexId u = 0; u < g.numVertices(); ++u) {
+            for (Neighbor nb : g.neighbors(u)) {
+                if (nb.w < 0) throw invalid_argument("delta-stepping不支持负权边");
+                sum += nb.w;
+            }
+        }
+        if (delta <= 0) delta = g.numArcs() > 0 ? max(1LL, sum / g.numArcs()) : 1;
+    }
+
+    Dist getDelta() const {
+        return delta;
+    }
+
+    // 单源最短路，结果写入out（长度n，不可达为INF_DIST）
+    void run(VertexId source, vector<Dist>& out) {
+        int n = g.numVertices();
+        for (int v = 0; v < n; ++v) dist[v].store(INF_DIST, memory_order_relaxed);
+        buckets.clear();
+        dist[source].store(0, memory_order_relaxed);
+        buckets[0].push_back(source);
+
+        vector<VertexId> frontier, settled;
+        while (!buckets.empty()) {
+            Dist b = buckets.begin()->first;
+            settled.clear();
+            while (buckets.count(b) && !buckets[b].empty()) {
+                // 取出当前桶，丢弃已移到其他桶的过期项，并在本轮内去重
+                vector<VertexId> raw;
+                raw.swap(buckets[b]);
+                curStamp++;
+                frontier.clear();
+                for (VertexId v : raw) {
+                    if (dist[v].load(memory_order_relaxed) / delta != b || stamp[v] == curStamp) continue;
+                    stamp[v] = curStamp;
+                    frontier.push_back(v);
+                }
+                for (VertexId v : frontier) settled.push_back(v);
+                relaxEdges(frontier, true);
+            }
+            buckets.erase(b);
+
+            // 当前桶内顶点距离已确定，松弛重边（重边不会回到本桶）
+            curStamp++;
+            frontier.clear();
+            for (VertexId v : settled) {
+                if (stamp[v] != curStamp) {
+                    stamp[v] = curStamp;
+                    frontier.push_back(v);
+                }
+            }
+            relaxEdges(frontier, false);
         }
-        adjMatrix.resize(n, vector<int>(n, 0));
+
+        out.resize(n);
+        for (int v = 0; v < n; ++v) out[v] = dist[v].load(memory_order_relaxed);
     }
+};
 
-    void addEdge(char v1, char v2, int weight) {
-        int i = vertexToIdx[v1];
-        int j = vertexToIdx[v2];
-        adjMatrix[i][j] = weight;
-        if (!isDirected) {
-            adjMatrix[j][i] = weight;
+// 多源批量：各源点相互独立，按线程切分源点，每个线程复用自己的Dijkstra引擎（工作区不重复分配）
+// visit(源点序号, 引擎) 在工作线程中调用，可从引擎读取该源点的全部距离
+template <typename Visit>
+void multiSourceShortestPaths(const CSRGraph& g, const vector<VertexId>& sources, ThreadPool& pool, Visit visit) {
+    parallelFor(pool, sources.size(), pool.size(), [&](size_t b, size_t e, int) {
+        DijkstraEngine<BinaryHeap> engine(g);
+        for (size_t i = b; i < e; ++i) {
+            engine.run(sources[i]);
+            visit(i, engine);
         }
-    }
+    });
+}
 
-    void printAdjMatrix() {
-        int n = idxToVertex.size();
-        cout << "邻接矩阵（行/列：";
-        for (char v : idxToVertex) cout << v << " ";
-        cout << "）：\n";
-        for (int i = 0; i < n; ++i) {
-            cout << idxToVertex[i] << ":\t";
-            for (int j = 0; j < n; ++j) {
-                cout << adjMatrix[i][j] << "\t";
+// 距离矩阵：sources.size() 行 × n 列，按行平铺
+vector<Dist> distanceMatrix(const CSRGraph& g, const vector<VertexId>& sources, ThreadPool& pool) {
+    int n = g.numVertices();
+    vector<Dist> matrix((size_t)sources.size() * n);
+    multiSourceShortestPaths(g, sources, pool, [&](size_t i, const DijkstraEngine<BinaryHeap>& engine) {
+        Dist* row = &matrix[i * n];
+        for (VertexId v = 0; v < n; ++v) row[v] = engine.distance(v);
+    });
+    return matrix;
+}
+
+// ============================== 动态图与增量最短路 ==============================
+// 一条边更新：插入（已存在时等同改权）、删除、改权（不存在时忽略）
+enum class UpdateKind { Insert, Remove, SetWeight };
+
+struct EdgeUpdate {
+    UpdateKind kind;
+    VertexId u, v;
+    Weight w;
+};
+
+// 一批更新中实际发生变化的弧（无向图两个方向各一条），present=false表示已删除
+struct ArcChange {
+    VertexId u, v;
+    bool present;
+    Weight w;
+};
+
+// 动态图：只读CSR基底 + 按行的写时复制覆盖层（增量日志）。
+// 首次修改某行时把该行复制进覆盖层，此后在覆盖层中有序插入/删除；
+// 覆盖层弧数超过基底的1/compactRatio时合并回新的CSR基底。有向图另外维护入弧（增量修复用）。
+class DynamicGraph {
+private:
+    struct Row {
+        vector<VertexId> t;
+        vector<Weight> w;
+    };
+
+    // 一个方向的邻接：基底 + 覆盖行
+    struct Side {
+        CSRGraph base;
+        vector<int> slot;  // 顶点 -> 覆盖行下标，-1表示未修改
+        vector<Row> rows;
+        EdgeId overlayArcs = 0;
+
+        NeighborSpan row(VertexId u) const {
+            if (slot[u] < 0) return base.neighbors(u);
+            const Row& r = rows[slot[u]];
+            return NeighborSpan(r.t.data(), r.w.data(), r.t.size());
+        }
+
+        Row& mutableRow(VertexId u) {
+            if (slot[u] < 0) {
+                NeighborSpan s = base.neighbors(u);
+                slot[u] = rows.size();
+                rows.push_back(Row{vector<VertexId>(s.targets(), s.targets() + s.size()),
+                                   vector<Weight>(s.weights(), s.weights() + s.size())});
+                overlayArcs += s.size();
             }
-            cout << "\n";
+            return rows[slot[u]];
+        }
+
+        // 写入或删除弧u->v，返回是否有变化
+        bool set(VertexId u, VertexId v, bool present, Weight w) {
+            NeighborSpan s = row(u);
+            const VertexId* it = lower_bound(s.targets(), s.targets() + s.size(), v);
+            size_t i = it - s.targets();
+            bool exists = i < s.size() && *it == v;
+            if (present ? (exists && s.weights()[i] == w) : !exists) return false;
+            Row& r = mutableRow(u);
+            if (!present) {
+                r.t.erase(r.t.begin() + i);
+                r.w.erase(r.w.begin() + i);
+            } else if (exists) {
+                r.w[i] = w;
+            } else {
+                r.t.insert(r.t.begin() + i, v);
+                r.w.insert(r.w.begin() + i, w);
+                overlayArcs++;
+            }
+            return true;
+        }
+
+        // 合并：按当前各行重建CSR（无向图只取u<=v的一半，由fromEdges补回反向弧）
+        void compact(bool directed) {
+            int n = base.numVertices();
+            vector<Edge> edges;
+            for (VertexId u = 0; u < n; ++u) {
+                for (Neighbor nb : row(u)) {
+                    if (directed || u <= nb.v) edges.push_back(Edge(u, nb.v, nb.w));
+                }
+            }
+            base = CSRGraph::fromEdges(n, edges, directed);
+            slot.assign(n, -1);
+            rows.clear();
+            overlayArcs = 0;
         }
+    };
+
+    bool directed;
+    int compactRatio;
+    Side out, in;
+    EdgeId arcs;
+
+    bool applyArc(VertexId u, VertexId v, bool present, Weight w, vector<ArcChange>& changes) {
+        if (!out.set(u, v, present, w)) return false;
+        if (directed) in.set(v, u, present, w);
+        changes.push_back(ArcChange{u, v, present, w});
+        return true;
     }
 
-    vector<pair<char, int>> getAdjacent(char v) {
-        vector<pair<char, int>> adj;
-        int i = vertexToIdx[v];
-        for (int j = 0; j < adjMatrix.size(); ++j) {
-            if (adjMatrix[i][j] > 0) {
-                adj.emplace_back(idxToVertex[j], adjMatrix[i][j]);
+public:
+    explicit DynamicGraph(const CSRGraph& g, int ratio = 8) : directed(g.isDirected()), compactRatio(ratio), arcs(g.numArcs()) {
+        out.base = g;
+        out.slot.assign(g.numVertices(), -1);
+        if (directed) {
+            in.base = g.reversed();
+            in.slot.assign(g.numVertices(), -1);
+        }
+    }
+
+    int numVertices() const { return out.base.numVertices(); }
+    EdgeId numArcs() const { return arcs; }
+    bool isDirected() const { return directed; }
+    EdgeId overlayArcs() const { return out.overlayArcs + in.overlayArcs; }
+
+    NeighborSpan neighbors(VertexId u) const { return out.row(u); }
+    NeighborSpan inNeighbors(VertexId u) const { return directed ? in.row(u) : out.row(u); }
+
+    // 查询弧u->v，存在时写出权重
+    bool findArc(VertexId u, VertexId v, Weight* w = nullptr) const {
+        NeighborSpan s = out.row(u);
+        const VertexId* it = lower_bound(s.targets(), s.targets() + s.size(), v);
+        if (it == s.targets() + s.size() || *it != v) return false;
+        if (w) *w = s.weights()[it - s.targets()];
+        return true;
+    }
+
+    // 按顺序应用一批更新，返回实际变化的弧；覆盖层过大时自动合并
+    vector<ArcChange> apply(const vector<EdgeUpdate>& batch) {
+        int n = numVertices();
+        vector<ArcChange> changes;
+        for (const EdgeUpdate& up : batch) {
+            if (up.u < 0 || up.u >= n || up.v < 0 || up.v >= n) throw out_of_range("边的端点超出顶点范围");
+            bool present = up.kind != UpdateKind::Remove;
+            if (up.kind == UpdateKind::SetWeight && !findArc(up.u, up.v)) continue;
+            bool existed = findArc(up.u, up.v);
+            if (!applyArc(up.u, up.v, present, up.w, changes)) continue;
+            if (!directed && up.u != up.v) applyArc(up.v, up.u, present, up.w, changes);
+            if (existed != present) {
+                EdgeId d = (!directed && up.u != up.v) ? 2 : 1;
+                arcs += present ? d : -d;
             }
         }
-        return adj;
+        if (overlayArcs() * compactRatio > arcs) compact();
+        return changes;
+    }
+
+    // 把覆盖层合并回CSR基底
+    void compact() {
+        out.compact(directed);
+        if (directed) in.compact(directed);
+    }
+
+    // 当前图的CSR快照（会先合并覆盖层）
+    const CSRGraph& snapshot() {
+        compact();
+        return out.base;
     }
 };
 
-// ============================== 任务2：BFS 和 DFS 算法 ==============================
-vector<char> BFS(Graph& graph, char start) {
-    vector<char> result;
-    set<char> visited;
-    queue<char> q;
+// 增量单源最短路：维护最短路树，每批更新后只修复受影响的部分（边权须非负）。
+// 1. 树弧parent[v]->v被删除或变长（dist[parent]+w != dist[v]）时，v的整棵子树失效，距离置为无穷，
+//    再由每个失效顶点的未失效入邻居给出候选距离；
+// 2. 新增或变短的弧u->v若使dist[u]+w < dist[v]，v以新距离入堆；
+// 3. 从这些种子出发做一次Dijkstra，只有距离真正改变的顶点才会继续松弛。
+// 其余顶点的旧距离仍是真实路径长度，且不可能经由未改变的弧得到改进，因此结果与重新计算一致。
+class IncrementalSSSP {
+private:
+    const DynamicGraph& g;
+    VertexId source;
+    vector<Dist> dist;
+    vector<VertexId> parent;
+    vector<char> affected;
+    BinaryHeap heap;
 
-    q.push(start);
-    visited.insert(start);
+    // 从堆中的种子做Dijkstra，返回出堆（重新定标）的顶点数
+    size_t relaxFrom() {
+        size_t settled = 0;
+        while (!heap.empty()) {
+            pair<Dist, VertexId> top = heap.pop();
+            VertexId u = top.second;
+            if (top.first != dist[u]) continue;
+            settled++;
+            for (Neighbor nb : g.neighbors(u)) {
+                Dist nd = dist[u] + nb.w;
+                if (nd < dist[nb.v]) {
+                    dist[nb.v] = nd;
+                    parent[nb.v] = u;
+                    heap.push(nd, nb.v);
+                }
+            }
+        }
+        return settled;
+    }
 
-    while (!q.empty()) {
-        char curr = q.front();
-        q.pop();
-        result.push_back(curr);
+public:
+    IncrementalSSSP(const DynamicGraph& graph, VertexId s) : g(graph), source(s) {
+        recompute();
+    }
 
-        vector<pair<char, int>> adj = graph.getAdjacent(curr);
-        sort(adj.begin(), adj.end(), [](const pair<char, int>& a, const pair<char, int>& b) {
-            return a.first < b.first;
-        });
+    // 从头计算（初始化或对照用）
+    void recompute() {
+        int n = g.numVertices();
+        dist.assign(n, INF_DIST);
+        parent.assign(n, -1);
+        affected.assign(n, 0);
+        heap.clear();
+        dist[source] = 0;
+        heap.push(0, source);
+        relaxFrom();
+    }
+
+    // 按一批弧变化修复最短路树，返回重新定标的顶点数。
+    // 同一条弧在一批中可能变化多次，因此一律按图的当前状态判断，不使用ArcChange中的权重
+    size_t repair(const vector<ArcChange>& changes) {
+        if ((int)dist.size() != g.numVertices()) {
+            recompute();
+            return dist.size();
+        }
+        heap.clear();
+        vector<VertexId> roots, sub;
+        Weight w;
+        for (const ArcChange& c : changes) {
+            if (parent[c.v] != c.u || affected[c.v]) continue;
+            if (!g.findArc(c.u, c.v, &w) || dist[c.u] + w != dist[c.v]) {
+                affected[c.v] = 1;
+                roots.push_back(c.v);
+            }
+        }
+
+        // 收集失效子树（子节点：出邻居中parent指向自己的顶点）
+        sub = roots;
+        for (size_t i = 0; i < sub.size(); ++i) {
+            VertexId u = sub[i];
+            for (Neighbor nb : g.neighbors(u)) {
+                if (parent[nb.v] == u && !affected[nb.v]) {
+                    affected[nb.v] = 1;
+                    sub.push_back(nb.v);
+                }
+            }
+        }
+        for (VertexId v : sub) {
+            dist[v] = INF_DIST;
+            parent[v] = -1;
+        }
+        for (VertexId v : sub) {
+            for (Neighbor nb : g.inNeighbors(v)) {
+                if (affected[nb.v] || dist[nb.v] == INF_DIST) continue;
+                Dist nd = dist[nb.v] + nb.w;
+                if (nd < dist[v]) {
+                    dist[v] = nd;
+                    parent[v] = nb.v;
+                }
+            }
+            if (dist[v] != INF_DIST) heap.push(dist[v], v);
+        }
+        for (VertexId v : sub) affected[v] = 0;
 
-        for (auto& p : adj) {
-            char nextV = p.first;
-            if (visited.find(nextV) == visited.end()) {
-                visited.insert(nextV);
-                q.push(nextV);
+        // 新增/变短的弧
+        for (const ArcChange& c : changes) {
+            if (dist[c.u] == INF_DIST || !g.findArc(c.u, c.v, &w)) continue;
+            Dist nd = dist[c.u] + w;
+            if (nd < dist[c.v]) {
+                dist[c.v] = nd;
+                parent[c.v] = c.u;
+                heap.push(nd, c.v);
             }
         }
+        return relaxFrom();
     }
-    return result;
-}
 
-void DFSRecursive(Graph& graph, char curr, set<char>& visited, vector<char>& result) {
-    visited.insert(curr);
-    result.push_back(curr);
+    Dist distance(VertexId v) const { return dist[v]; }
+    VertexId parentOf(VertexId v) const { return parent[v]; }
+    const vector<Dist>& distances() const { return dist; }
+};
 
-    vector<pair<char, int>> adj = graph.getAdjacent(curr);
-    sort(adj.begin(), adj.end(), [](const pair<char, int>& a, const pair<char, int>& b) {
-        return a.first < b.first;
-    });
+// ============================== 最小支撑树/森林：Prim、Kruskal、Borůvka ==============================
+// 三种引擎接口一致：结果写入调用方提供的out（先清空，容量复用），返回总权重；
+// 图不连通时得到最小支撑森林（边数 = 顶点数 - 连通分量数）。只适用于无向图。
+struct MSTEdge {
+    VertexId u, v;
+    Weight w;
+};
+
+// 并查集：按大小合并 + 路径减半
+class DisjointSet {
+private:
+    vector<VertexId> parent;
+    vector<int> sz;
+
+public:
+    DisjointSet(int n = 0) { reset(n); }
 
-    for (auto& p : adj) {
-        char nextV = p.first;
-        if (visited.find(nextV) == visited.end()) {
-            DFSRecursive(graph, nextV, visited, result);
+    void reset(int n) {
+        parent.resize(n);
+        sz.assign(n, 1);
+        for (int i = 0; i < n; ++i) parent[i] = i;
+    }
+
+    VertexId find(VertexId x) {
+        while (parent[x] != x) {
+            parent[x] = parent[parent[x]];
+            x = parent[x];
         }
+        return x;
+    }
+
+    // 合并两个集合，原本已在同一集合时返回false
+    bool unite(VertexId a, VertexId b) {
+        a = find(a);
+        b = find(b);
+        if (a == b) return false;
+        if (sz[a] < sz[b]) swap(a, b);
+        parent[b] = a;
+        sz[a] += sz[b];
+        return true;
     }
+};
+
+void requireUndirected(const CSRGraph& g) {
+    if (g.isDirected()) throw invalid_argument("最小支撑树只适用于无向图");
 }
 
-vector<char> DFS(Graph& graph, char start) {
-    vector<char> result;
-    set<char> visited;
-    DFSRecursive(graph, start, visited, result);
-    return result;
+// 无向图的边表（每条边只取 u < v 的一条弧）
+vector<MSTEdge> undirectedEdges(const CSRGraph& g) {
+    vector<MSTEdge> edges;
+    edges.reserve(g.numArcs() / 2);
+    for (VertexId u = 0; u < g.numVertices(); ++u) {
+        for (Neighbor nb : g.neighbors(u)) {
+            if (u < nb.v) edges.push_back(MSTEdge{u, nb.v, nb.w});
+        }
+    }
+    return edges;
 }
 
-// ============================== 任务3：最短路径（Dijkstra）和最小支撑树（Prim） ==============================
-pair<map<char, int>, map<char, char>> Dijkstra(Graph& graph, char start) {
-    int n = graph.idxToVertex.size();
-    map<char, int> dist;
-    map<char, char> prev;
-    set<char> visited;
-
-    for (char v : graph.idxToVertex) {
-        dist[v] = INT_MAX;
-        prev[v] = '\0';
-    }
-    dist[start] = 0;
-
-    while (visited.size() < n) {
-        char curr = '\0';
-        int minDist = INT_MAX;
-        for (char v : graph.idxToVertex) {
-            if (visited.find(v) == visited.end() && dist[v] < minDist) {
-                minDist = dist[v];
-                curr = v;
-            }
-        }
-        if (curr == '\0') break;
-        visited.insert(curr);
-
-        vector<pair<char, int>> adj = graph.getAdjacent(curr);
-        for (auto& p : adj) {
-            char nextV = p.first;
-            int weight = p.second;
-            if (visited.find(nextV) == visited.end() && dist[curr] != INT_MAX) {
-                int newDist = dist[curr] + weight;
-                if (newDist < dist[nextV]) {
-                    dist[nextV] = newDist;
-                    prev[nextV] = curr;
+// Prim（堆 + 最优键数组）：key[v]记录v连向树的最小边权，只在变小时入堆，
+// 与带decrease-key的索引堆等价；从start所在分量开始，其余分量依次作为新树根
+Dist primMST(const CSRGraph& g, vector<MSTEdge>& out, VertexId start = 0) {
+    requireUndirected(g);
+    int n = g.numVertices();
+    out.clear();
+    if (n == 0) return 0;
+    vector<Weight> key(n, INT_MAX);
+    vector<VertexId> from(n, -1); // -1表示尚未被任何树顶点触及（不用key==INT_MAX判断，权为INT_MAX的边同样合法）
+    vector<char> inTree(n, 0);
+    BinaryHeap heap;
+    Dist total = 0;
+
+    for (int k = 0; k < n; ++k) {
+        VertexId root = k == 0 ? start : k - (k <= start ? 1 : 0);
+        if (inTree[root]) continue;
+        heap.push(0, root);
+        from[root] = -1;
+        while (!heap.empty()) {
+            pair<Dist, VertexId> top = heap.pop();
+            VertexId u = top.second;
+            if (inTree[u]) continue;
+            inTree[u] = 1;
+            if (from[u] >= 0) {
+                out.push_back(MSTEdge{from[u], u, key[u]});
+                total += key[u];
+            }
+            for (Neighbor nb : g.neighbors(u)) {
+                if (!inTree[nb.v] && (from[nb.v] < 0 || nb.w < key[nb.v])) {
+                    key[nb.v] = nb.w;
+                    from[nb.v] = u;
+                    heap.push(nb.w, nb.v);
                 }
             }
         }
     }
-
-    return make_pair(dist, prev);
+    return total;
 }
 
-void printDijkstraPath(map<char, char>& prev, char start, char target) {
-    vector<char> path;
-    for (char v = target; v != '\0'; v = prev[v]) {
-        path.push_back(v);
-    }
-    reverse(path.begin(), path.end());
-
-    cout << "路径 " << start << "->" << target << "：";
-    if (path[0] != start) {
-        cout << "无\n";
+// 并行排序：各块在线程池上分别排序，再逐轮两两归并
+template <typename T, typename Cmp>
+void parallelSort(ThreadPool& pool, vector<T>& a, Cmp cmp) {
+    int chunks = pool.size();
+    if (chunks <= 1 || a.size() < 65536) {
+        sort(a.begin(), a.end(), cmp);
         return;
     }
-    for (int i = 0; i < path.size(); ++i) {
-        if (i > 0) cout << "->";
-        cout << path[i];
+    vector<size_t> bounds;
+    for (int c = 0; c <= chunks; ++c) bounds.push_back(a.size() * c / chunks);
+    parallelFor(pool, chunks, chunks, [&](size_t b, size_t e, int) {
+        for (size_t c = b; c < e; ++c) sort(a.begin() + bounds[c], a.begin() + bounds[c + 1], cmp);
+    });
+    for (size_t width = 1; width < (size_t)chunks; width *= 2) {
+        vector<size_t> lefts;
+        for (size_t c = 0; c + width < (size_t)chunks; c += 2 * width) lefts.push_back(c);
+        parallelFor(pool, lefts.size(), lefts.size(), [&](size_t b, size_t e, int) {
+            for (size_t i = b; i < e; ++i) {
+                size_t c = lefts[i];
+                size_t mid = bounds[c + width], hi = bounds[min(c + 2 * width, (size_t)chunks)];
+                inplace_merge(a.begin() + bounds[c], a.begin() + mid, a.begin() + hi, cmp);
+            }
+        });
     }
-    cout << "\n";
 }
 
-pair<vector<tuple<char, char, int>>, int> Prim(Graph& graph, char start) {
-    int n = graph.idxToVertex.size();
-    set<char> inMST;
-    vector<tuple<char, char, int>> mstEdges;
-    int totalWeight = 0;
-
-    inMST.insert(start);
-
-    while (inMST.size() < n) {
-        tuple<char, char, int> minEdge = make_tuple('\0', '\0', INT_MAX);
-        for (char u : inMST) {
-            vector<pair<char, int>> adj = graph.getAdjacent(u);
-            for (auto& p : adj) {
-                char v = p.first;
-                int weight = p.second;
-                if (inMST.find(v) == inMST.end() && weight < get<2>(minEdge)) {
-                    minEdge = make_tuple(u, v, weight);
-                }
+// Kruskal：边按权重并行排序，再用并查集依次加入不成环的边
+Dist kruskalMST(const CSRGraph& g, vector<MSTEdge>& out, ThreadPool& pool) {
+    requireUndirected(g);
+    out.clear();
+    vector<MSTEdge> edges = undirectedEdges(g);
+    parallelSort(pool, edges, [](const MSTEdge& a, const MSTEdge& b) { return a.w < b.w; });
+
+    DisjointSet ds(g.numVertices());
+    Dist total = 0;
+    for (const MSTEdge& e : edges) {
+        if (ds.unite(e.u, e.v)) {
+            out.push_back(e);
+            total += e.w;
+            if ((int)out.size() == g.numVertices() - 1) break;
+        }
+    }
+    return total;
+}
+
+// Borůvka：每轮并行地为每个分量找最轻的出边（权重相同时按边号，避免成环），
+// 全部加入后合并分量并剔除分量内部的边，至多 O(log V) 轮
+Dist boruvkaMST(const CSRGraph& g, vector<MSTEdge>& out, ThreadPool& pool) {
+    requireUndirected(g);
+    int n = g.numVertices();
+    out.clear();
+    vector<MSTEdge> edges = undirectedEdges(g);
+    if (edges.size() >= (1ULL << 32)) throw length_error("Borůvka的边数超出32位编号范围");
+
+    const unsigned long long NONE = ULLONG_MAX;
+    unique_ptr<atomic<unsigned long long>[]> best(new atomic<unsigned long long>[n]);
+    vector<VertexId> comp(n);
+    for (int v = 0; v < n; ++v) comp[v] = v;
+    DisjointSet ds(n);
+    int chunks = 4 * pool.size();
+    Dist total = 0;
+
+    // 权重与边号打包成可比较的64位键：高32位为偏移后的权重，低32位为边号
+    auto packKey = [](Weight w, size_t idx) {
+        return ((unsigned long long)((long long)w - INT_MIN) << 32) | idx;
+    };
+    auto atomicMin = [](atomic<unsigned long long>& slot, unsigned long long key) {
+        unsigned long long cur = slot.load(memory_order_relaxed);
+        while (key < cur && !slot.compare_exchange_weak(cur, key, memory_order_relaxed)) {}
+    };
+
+    while (!edges.empty()) {
+        for (int v = 0; v < n; ++v) best[v].store(NONE, memory_order_relaxed);
+        parallelFor(pool, edges.size(), chunks, [&](size_t b, size_t e, int) {
+            for (size_t i = b; i < e; ++i) {
+                unsigned long long key = packKey(edges[i].w, i);
+                atomicMin(best[comp[edges[i].u]], key);
+                atomicMin(best[comp[edges[i].v]], key);
+            }
+        });
+
+        bool merged = false;
+        for (int c = 0; c < n; ++c) {
+            unsigned long long key = best[c].load(memory_order_relaxed);
+            if (key == NONE) continue;
+            const MSTEdge& e = edges[key & 0xFFFFFFFFULL];
+            if (ds.unite(e.u, e.v)) {
+                out.push_back(e);
+                total += e.w;
+                merged = true;
             }
         }
-        if (get<2>(minEdge) == INT_MAX) break;
+        if (!merged) break;
 
-        char u = get<0>(minEdge), v = get<1>(minEdge), w = get<2>(minEdge);
-        mstEdges.push_back(minEdge);
-        totalWeight += w;
-        inMST.insert(v);
+        // 更新分量编号（并查集已在本轮串行合并完成，这里逐点压缩后只读）
+        for (int v = 0; v < n; ++v) comp[v] = ds.find(v);
+        vector<vector<MSTEdge>> kept(chunks);
+        parallelFor(pool, edges.size(), chunks, [&](size_t b, size_t e, int chunk) {
+            for (size_t i = b; i < e; ++i) {
+                if (comp[edges[i].u] != comp[edges[i].v]) kept[chunk].push_back(edges[i]);
+            }
+        });
+        edges.clear();
+        for (auto& k : kept) edges.insert(edges.end(), k.begin(), k.end());
     }
+    return total;
+}
 
+// 字符标签层的Prim（保持原有接口；边权不再被截断为char）
+pair<vector<tuple<char, char, int>>, Dist> Prim(Graph& graph, char start) {
+    vector<MSTEdge> edges;
+    Dist totalWeight = primMST(graph.csr(), edges, graph.id(start));
+    vector<tuple<char, char, int>> mstEdges;
+    for (const MSTEdge& e : edges) {
+        mstEdges.push_back(make_tuple(graph.label(e.u), graph.label(e.v), e.w));
+    }
     return make_pair(mstEdges, totalWeight);
 }
 
 // ============================== 任务4：双连通分量和关节点（Tarjan算法） ==============================
-class TarjanBiconnected {
-private:
-    Graph& graph;
-    map<char, int> disc;
-    map<char, int> low;
-    map<char, char> parent;
-    set<char> visited;
-    stack<pair<char, char>> edgeStack;
-    vector<vector<pair<char, char>>> bcc;
-    set<char> articulationPoints;
-    int time;
-
-    void dfs(char u) {
-        visited.insert(u);
-        disc[u] = low[u] = ++time;
-        int children = 0;
-
-        vector<pair<char, int>> adj = graph.getAdjacent(u);
-        for (auto& p : adj) {
-            char v = p.first;
-            if (!visited.count(v)) {
-                children++;
-                parent[v] = u;
-                edgeStack.push(make_pair(u, v));
-                dfs(v);
-
-                low[u] = min(low[u], low[v]);
-
-                if ((parent[u] == '\0' && children > 1) || (parent[u] != '\0' && low[v] >= disc[u])) {
-                    articulationPoints.insert(u);
-                    vector<pair<char, char>> component;
-                    while (edgeStack.top() != make_pair(u, v)) {
-                        component.push_back(edgeStack.top());
-                        edgeStack.pop();
-                    }
-                    component.push_back(edgeStack.top());
-                    edgeStack.pop();
-                    bcc.push_back(component);
+// 双连通分量的计算结果（整数编号）：分量按边平铺存储，分量i的边为 compEdges[compOffsets[i] .. compOffsets[i+1])
+struct BiconnectedResult {
+    vector<EdgeId> compOffsets;
+    vector<pair<VertexId, VertexId>> compEdges;
+    vector<char> isArticulation;                 // 是否为关节点（割点）
+    vector<pair<VertexId, VertexId>> bridges;    // 桥
+
+    int numComponents() const {
+        return (int)compOffsets.size() - 1;
+    }
+};
+
+// 迭代版Tarjan：显式栈 + 平坦数组，依次以每个未访问顶点为根，覆盖整张图的所有连通分量
+// （start所在的分量最先处理）。只适用于无向图。
+BiconnectedResult biconnectedComponents(const CSRGraph& g, VertexId start = 0) {
+    if (g.isDirected()) throw invalid_argument("双连通分量只适用于无向图");
+    int n = g.numVertices();
+    BiconnectedResult res;
+    res.compOffsets.push_back(0);
+    res.isArticulation.assign(n, 0);
+    if (n == 0) return res;
+
+    vector<int> disc(n, 0), low(n, 0);
+    vector<VertexId> parent(n, -1);
+    vector<EdgeId> iter(n);
+    vector<VertexId> stk;
+    vector<pair<VertexId, VertexId>> edgeStack;
+    int time = 0;
+
+    for (int k = 0; k < n; ++k) {
+        VertexId root = k == 0 ? start : k - (k <= start ? 1 : 0);
+        if (disc[root]) continue;
+        int rootChildren = 0;
+        disc[root] = low[root] = ++time;
+        iter[root] = g.edgeBegin(root);
+        stk.push_back(root);
+
+        while (!stk.empty()) {
+            VertexId u = stk.back();
+            if (iter[u] < g.edgeEnd(u)) {
+                VertexId v = g.target(iter[u]++);
+                if (v == u) continue; // 自环不影响双连通性
+                if (!disc[v]) {
+                    parent[v] = u;
+                    disc[v] = low[v] = ++time;
+                    iter[v] = g.edgeBegin(v);
+                    edgeStack.push_back(make_pair(u, v));
+                    stk.push_back(v);
+                    if (u == root) rootChildren++;
+                } else if (v != parent[u] && disc[v] < disc[u]) {
+                    edgeStack.push_back(make_pair(u, v));
+                    low[u] = min(low[u], disc[v]);
+                }
+                continue;
+            }
+
+            // u的邻居已处理完，回溯到父节点p
+            stk.pop_back();
+            VertexId p = parent[u];
+            if (p < 0) continue;
+            low[p] = min(low[p], low[u]);
+            if (low[u] > disc[p]) res.bridges.push_back(make_pair(p, u));
+            if (low[u] >= disc[p]) {
+                if (p != root) res.isArticulation[p] = 1;
+                // 弹出到(p,u)为止的边构成一个双连通分量
+                while (true) {
+                    pair<VertexId, VertexId> e = edgeStack.back();
+                    edgeStack.pop_back();
+                    res.compEdges.push_back(e);
+                    if (e.first == p && e.second == u) break;
                 }
-            } else if (v != parent[u] && disc[v] < disc[u]) {
-                edgeStack.push(make_pair(u, v));
-                low[u] = min(low[u], disc[v]);
+                res.compOffsets.push_back(res.compEdges.size());
             }
         }
+        if (rootChildren > 1) res.isArticulation[root] = 1;
     }
+    return res;
+}
 
-public:
-    TarjanBiconnected(Graph& g) : graph(g), time(0) {}
+// 块-割点树：前numBlocks个节点是双连通分量（块），之后每个节点对应一个关节点；
+// 块与其包含的关节点之间连边。图连通时这是一棵树，否则是森林。
+struct BlockCutTree {
+    int numBlocks;
+    vector<VertexId> cutVertex;   // 树节点 numBlocks+i 对应的原图关节点
+    CSRGraph tree;
+};
 
-    pair<vector<vector<pair<char, char>>>, set<char>> run(char start) {
-        disc.clear(); low.clear(); parent.clear(); visited.clear();
-        edgeStack = stack<pair<char, char>>();
-        bcc.clear(); articulationPoints.clear(); time = 0;
-
-        if (!visited.count(start)) {
-            dfs(start);
-            if (!edgeStack.empty()) {
-                vector<pair<char, char>> component;
-                while (!edgeStack.empty()) {
-                    component.push_back(edgeStack.top());
-                    edgeStack.pop();
+BlockCutTree buildBlockCutTree(const CSRGraph& g, const BiconnectedResult& bcc) {
+    BlockCutTree bct;
+    bct.numBlocks = bcc.numComponents();
+    vector<VertexId> nodeOf(g.numVertices(), -1);
+    for (VertexId v = 0; v < g.numVertices(); ++v) {
+        if (bcc.isArticulation[v]) {
+            nodeOf[v] = bct.numBlocks + bct.cutVertex.size();
+            bct.cutVertex.push_back(v);
+        }
+    }
+
+    vector<Edge> edges;
+    vector<int> seen(g.numVertices(), -1); // 按块号去重
+    for (int b = 0; b < bct.numBlocks; ++b) {
+        for (EdgeId i = bcc.compOffsets[b]; i < bcc.compOffsets[b + 1]; ++i) {
+            for (VertexId v : {bcc.compEdges[i].first, bcc.compEdges[i].second}) {
+                if (nodeOf[v] >= 0 && seen[v] != b) {
+                    seen[v] = b;
+                    edges.push_back(Edge(b, nodeOf[v], 1));
                 }
-                bcc.push_back(component);
             }
         }
+    }
+    bct.tree = CSRGraph::fromEdges(bct.numBlocks + bct.cutVertex.size(), edges, false);
+    return bct;
+}
+
+// 字符标签层（保持原有接口）
+class TarjanBiconnected {
+private:
+    Graph& graph;
+    vector<pair<char, char>> bridgeList;
+
+public:
+    TarjanBiconnected(Graph& g) : graph(g) {}
 
+    pair<vector<vector<pair<char, char>>>, set<char>> run(char start) {
+        BiconnectedResult res = biconnectedComponents(graph.csr(), graph.id(start));
+        vector<vector<pair<char, char>>> bcc;
+        for (int c = 0; c < res.numComponents(); ++c) {
+            vector<pair<char, char>> component;
+            for (EdgeId i = res.compOffsets[c]; i < res.compOffsets[c + 1]; ++i) {
+                component.push_back(make_pair(graph.label(res.compEdges[i].first), graph.label(res.compEdges[i].second)));
+            }
+            bcc.push_back(component);
+        }
+        set<char> articulationPoints;
+        for (VertexId v = 0; v < graph.numVertices(); ++v) {
+            if (res.isArticulation[v]) articulationPoints.insert(graph.label(v));
+        }
+        bridgeList.clear();
+        for (auto& e : res.bridges) bridgeList.push_back(make_pair(graph.label(e.first), graph.label(e.second)));
         return make_pair(bcc, articulationPoints);
     }
+
+    // 上一次run得到的桥
+    const vector<pair<char, char>>& bridges() const {
+        return bridgeList;
+    }
 };
 
 void printBCC(vector<vector<pair<char, char>>>& bcc) {
@@ -333,8 +2636,368 @@ Graph buildGraph2() {
     return graph;
 }
 
+// 合成网格图（模拟道路网）：rows×cols个格点，四邻接，权重为 10~29 的随机整数；
+// 坐标单位为格距，因此权重 >= 10 × 欧氏距离，可配合 EuclideanHeuristic(scale=10) 使用
+CSRGraph buildGridGraph(int rows, int cols, unsigned long long seed, vector<double>* xs = nullptr, vector<double>* ys = nullptr) {
+    datagen::Rng rng(seed);
+    vector<Edge> edges;
+    edges.reserve(2LL * rows * cols);
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c) {
+            VertexId v = r * cols + c;
+            if (c + 1 < cols) edges.push_back(Edge(v, v + 1, 10 + rng.below(20)));
+            if (r + 1 < rows) edges.push_back(Edge(v, v + cols, 10 + rng.below(20)));
+        }
+    }
+    if (xs && ys) {
+        xs->resize(rows * cols);
+        ys->resize(rows * cols);
+        for (VertexId v = 0; v < rows * cols; ++v) {
+            (*xs)[v] = v % cols;
+            (*ys)[v] = v / cols;
+        }
+    }
+    return CSRGraph::fromEdges(rows * cols, edges, false);
+}
+
+// 合成类道路图：抖动网格上的顶点，连接右、下邻居并以一定概率连对角线、随机删去部分道路；
+// 每隔16行/列是一条"快速路"（单位长度权重更低），权重 >= 10 × 欧氏距离
+CSRGraph buildRoadLikeGraph(int n, unsigned long long seed, vector<double>* xs = nullptr, vector<double>* ys = nullptr) {
+    datagen::Rng rng(seed);
+    int side = max(1, (int)sqrt((double)n));
+    n = side * side;
+    vector<double> px(n), py(n);
+    for (VertexId v = 0; v < n; ++v) {
+        px[v] = v % side + rng.below(1000) / 2500.0;
+        py[v] = v / side + rng.below(1000) / 2500.0;
+    }
+    auto roadWeight = [&](VertexId a, VertexId b, bool highway) {
+        double len = hypot(px[a] - px[b], py[a] - py[b]);
+        double factor = highway ? 1.0 : 1.5 + rng.below(1000) / 1000.0;
+        return (Weight)ceil(10.0 * factor * len);
+    };
+
+    vector<Edge> edges;
+    edges.reserve(3LL * n);
+    for (int r = 0; r < side; ++r) {
+        for (int c = 0; c < side; ++c) {
+            VertexId v = r * side + c;
+            if (c + 1 < side && (r % 16 == 0 || rng.below(10) != 0)) edges.push_back(Edge(v, v + 1, roadWeight(v, v + 1, r % 16 == 0)));
+            if (r + 1 < side && (c % 16 == 0 || rng.below(10) != 0)) edges.push_back(Edge(v, v + side, roadWeight(v, v + side, c % 16 == 0)));
+            if (r + 1 < side && c + 1 < side && rng.below(10) < 3) edges.push_back(Edge(v, v + side + 1, roadWeight(v, v + side + 1, false)));
+        }
+    }
+    if (xs && ys) {
+        *xs = px;
+        *ys = py;
+    }
+    return CSRGraph::fromEdges(n, edges, false);
+}
+
+// ============================== 基准测试 ==============================
+// 延迟统计：均值、p50、p99（单位微秒）
+struct LatencyStats {
+    double mean, p50, p99;
+};
+
+LatencyStats summarize(vector<double> us) {
+    LatencyStats s{0, 0, 0};
+    if (us.empty()) return s;
+    sort(us.begin(), us.end());
+    for (double x : us) s.mean += x;
+    s.mean /= us.size();
+    s.p50 = us[us.size() / 2];
+    s.p99 = us[min(us.size() - 1, (size_t)(us.size() * 0.99))];
+    return s;
+}
+
+// CH与Dijkstra（提前结束）的查询延迟对比：预处理 -> 存盘 -> 读盘 -> 随机点对查询并校验距离
+void benchmarkCH(const string& name, const CSRGraph& g, int queries) {
+    cout << "--- " << name << "：" << g.numVertices() << " 个顶点，" << g.numArcs() << " 条弧 ---\n";
+    auto t0 = chrono::steady_clock::now();
+    ContractionHierarchy built = ContractionHierarchy::build(g);
+    auto t1 = chrono::steady_clock::now();
+    string file = "ch_bench.tmp";
+    built.save(file);
+    auto t2 = chrono::steady_clock::now();
+    ContractionHierarchy ch = ContractionHierarchy::load(file);
+    auto t3 = chrono::steady_clock::now();
+    remove(file.c_str());
+    cout << fixed << setprecision(2);
+    cout << "预处理 " << chrono::duration<double>(t1 - t0).count() << " s，捷径 " << ch.numShortcuts()
+         << " 条；存盘 " << chrono::duration<double, milli>(t2 - t1).count() << " ms，读盘 "
+         << chrono::duration<double, milli>(t3 - t2).count() << " ms\n";
+
+    datagen::Rng rng(12345);
+    vector<pair<VertexId, VertexId>> pairs(queries);
+    for (auto& p : pairs) p = make_pair(rng.below(g.numVertices()), rng.below(g.numVertices()));
+
+    CHQuery chq(ch);
+    DijkstraEngine<BinaryHeap> dij(g);
+    vector<double> chUs, dijUs;
+    int dijQueries = min(queries, 200);
+    int mismatches = 0;
+    for (int i = 0; i < queries; ++i) {
+        auto a = chrono::steady_clock::now();
+        PathResult r = chq.query(pairs[i].first, pairs[i].second);
+        auto b = chrono::steady_clock::now();
+        chUs.push_back(chrono::duration<double, micro>(b - a).count());
+        if (i < dijQueries) {
+            auto c = chrono::steady_clock::now();
+            Dist d = dij.run(pairs[i].first, pairs[i].second);
+            auto e = chrono::steady_clock::now();
+            dijUs.push_back(chrono::duration<double, micro>(e - c).count());
+            if (d != r.dist) mismatches++;
+        }
+    }
+    LatencyStats cs = summarize(chUs), ds = summarize(dijUs);
+    cout << "CH（含路径展开）  均值 " << cs.mean << " us，p50 " << cs.p50 << " us，p99 " << cs.p99 << " us（" << queries << " 次）\n";
+    cout << "Dijkstra           均值 " << ds.mean << " us，p50 " << ds.p50 << " us，p99 " << ds.p99 << " us（" << dijQueries << " 次）\n";
+    cout << "距离校验：" << (mismatches == 0 ? "全部一致" : to_string(mismatches) + " 次不一致") << "\n\n";
+}
+
+// delta-stepping与串行Dijkstra的一对多对比，以及多源批量的并行加速比
+void benchmarkParallelSSSP(const CSRGraph& g, int threads, Dist delta, int sources) {
+    cout << "--- " << g.numVertices() << " 个顶点，" << g.numArcs() << " 条弧，" << threads << " 个线程 ---\n";
+    cout << fixed << setprecision(2);
+    ThreadPool pool(threads);
+
+    DijkstraEngine<BinaryHeap> dij(g);
+    auto t0 = chrono::steady_clock::now();
+    dij.run(0);
+    auto t1 = chrono::steady_clock::now();
+    DeltaStepping ds(g, pool, delta);
+    vector<Dist> dsDist;
+    auto t2 = chrono::steady_clock::now();
+    ds.run(0, dsDist);
+    auto t3 = chrono::steady_clock::now();
+    int mismatches = 0;
+    for (VertexId v = 0; v < g.numVertices(); ++v) {
+        if (dsDist[v] != dij.distance(v)) mismatches++;
+    }
+    cout << "一对多：Dijkstra " << chrono::duration<double, milli>(t1 - t0).count() << " ms，delta-stepping(delta="
+         << ds.getDelta() << ") " << chrono::duration<double, milli>(t3 - t2).count() << " ms，"
+         << (mismatches == 0 ? "结果一致" : to_string(mismatches) + " 处不一致") << "\n";
+
+    vector<VertexId> srcs;
+    for (int i = 0; i < sources; ++i) srcs.push_back((VertexId)((long long)i * g.numVertices() / sources));
+    ThreadPool single(1);
+    auto t4 = chrono::steady_clock::now();
+    vector<Dist> seq = distanceMatrix(g, srcs, single);
+    auto t5 = chrono::steady_clock::now();
+    vector<Dist> par = distanceMatrix(g, srcs, pool);
+    auto t6 = chrono::steady_clock::now();
+    double seqMs = chrono::duration<double, milli>(t5 - t4).count();
+    double parMs = chrono::duration<double, milli>(t6 - t5).count();
+    cout << "多源（" << sources << " 个源点）：单线程 " << seqMs << " ms，" << threads << " 线程 " << parMs
+         << " ms，加速比 " << seqMs / max(parMs, 1e-9) << "，" << (seq == par ? "结果一致" : "结果不一致") << "\n\n";
+}
+
+// 三种MST引擎的耗时对比，并校验总权重与边数一致
+void benchmarkMST(const string& name, const CSRGraph& g, int threads) {
+    cout << "--- " << name << "：" << g.numVertices() << " 个顶点，" << g.numArcs() / 2 << " 条边，" << threads << " 个线程 ---\n";
+    cout << fixed << setprecision(2);
+    ThreadPool pool(threads);
+    vector<MSTEdge> out;
+    out.reserve(g.numVertices());
+
+    auto t0 = chrono::steady_clock::now();
+    Dist wp = primMST(g, out);
+    size_t np = out.size();
+    auto t1 = chrono::steady_clock::now();
+    Dist wk = kruskalMST(g, out, pool);
+    size_t nk = out.size();
+    auto t2 = chrono::steady_clock::now();
+    Dist wb = boruvkaMST(g, out, pool);
+    size_t nb = out.size();
+    auto t3 = chrono::steady_clock::now();
+
+    cout << "Prim    " << chrono::duration<double, milli>(t1 - t0).count() << " ms，总权重 " << wp << "，" << np << " 条边\n";
+    cout << "Kruskal " << chrono::duration<double, milli>(t2 - t1).count() << " ms，总权重 " << wk << "，" << nk << " 条边\n";
+    cout << "Borůvka " << chrono::duration<double, milli>(t3 - t2).count() << " ms，总权重 " << wb << "，" << nb << " 条边\n";
+    cout << "校验：" << (wp == wk && wk == wb && np == nk && nk == nb ? "一致" : "不一致") << "\n\n";
+}
+
+// 确定性串行BFS与方向优化并行BFS的对比，校验层号一致
+void benchmarkBFS(const string& name, const CSRGraph& g, int threads) {
+    cout << "--- " << name << "：" << g.numVertices() << " 个顶点，" << g.numArcs() << " 条弧，" << threads << " 个线程 ---\n";
+    cout << fixed << setprecision(2);
+    ThreadPool pool(threads);
+    ParallelBFS bfs(g, pool);
+    auto t0 = chrono::steady_clock::now();
+    BFSResult a = bfs.run(0, BFSMode::Deterministic);
+    auto t1 = chrono::steady_clock::now();
+    BFSResult b = bfs.run(0, BFSMode::DirectionOptimizing);
+    auto t2 = chrono::steady_clock::now();
+    double ms = chrono::duration<double, milli>(t2 - t1).count();
+    cout << "确定性BFS " << chrono::duration<double, milli>(t1 - t0).count() << " ms，方向优化BFS " << ms
+         << " ms（" << g.numArcs() / max(ms, 1e-9) / 1000.0 << " M弧/秒），访问 " << b.order.size() << " 个顶点，"
+         << (a.level == b.level ? "层号一致" : "层号不一致") << "\n\n";
+}
+
+// 合成幂律图（模拟社交网络）：优先连接，每个新顶点连向m个已有顶点
+CSRGraph buildPowerLawGraph(int n, int m, unsigned long long seed) {
+    datagen::Rng rng(seed);
+    vector<Edge> edges;
+    vector<VertexId> endpoints; // 按度数加权抽样
+    edges.reserve((size_t)n * m);
+    for (VertexId v = 1; v < n; ++v) {
+        for (int k = 0; k < m; ++k) {
+            VertexId u = endpoints.empty() ? 0 : endpoints[rng.below(endpoints.size())];
+            edges.push_back(Edge(v, u, 1));
+            endpoints.push_back(u);
+            endpoints.push_back(v);
+        }
+    }
+    return CSRGraph::fromEdges(n, edges, false);
+}
+
+// 动态路网：每批随机改权（模拟路况变化）并夹杂少量删边/加边，比较增量修复与重新计算
+void benchmarkDynamicSSSP(const CSRGraph& base, int batches, int batchSize) {
+    cout << "--- 动态图：" << base.numVertices() << " 个顶点，" << base.numArcs() << " 条弧，" << batches
+         << " 批，每批 " << batchSize << " 条更新 ---\n";
+    datagen::Rng rng(2025);
+    DynamicGraph g(base);
+    IncrementalSSSP inc(g, 0);
+    double repairMs = 0, fullMs = 0;
+    size_t touched = 0;
+    bool allSame = true;
+    int n = g.numVertices();
+    for (int b = 0; b < batches; ++b) {
+        vector<EdgeUpdate> batch;
+        while ((int)batch.size() < batchSize) {
+            VertexId u = rng.below(n);
+            NeighborSpan s = g.neighbors(u);
+            int r = rng.below(100);
+            if (r < 2) {
+                batch.push_back(EdgeUpdate{UpdateKind::Insert, u, (VertexId)rng.below(n), (Weight)(1 + rng.below(100))});
+            } else if (s.empty()) {
+                continue;
+            } else if (r < 4) {
+                batch.push_back(EdgeUpdate{UpdateKind::Remove, u, s[rng.below(s.size())].v, 0});
+            } else {
+                Neighbor nb = s[rng.below(s.size())];
+                Weight w = max<Weight>(1, (Weight)(nb.w * (0.5 + rng.below(1501) / 1000.0)));
+                batch.push_back(EdgeUpdate{UpdateKind::SetWeight, u, nb.v, w});
+            }
+        }
+        vector<ArcChange> changes = g.apply(batch);
+        auto t0 = chrono::steady_clock::now();
+        touched += inc.repair(changes);
+        auto t1 = chrono::steady_clock::now();
+        IncrementalSSSP full(g, 0);
+        auto t2 = chrono::steady_clock::now();
+        repairMs += chrono::duration<double, milli>(t1 - t0).count();
+        fullMs += chrono::duration<double, milli>(t2 - t1).count();
+        if (full.distances() != inc.distances()) allSame = false;
+    }
+    cout << fixed << setprecision(3);
+    cout << "增量修复：平均每批 " << repairMs / batches << " ms，重新定标 " << touched / batches << " 个顶点\n";
+    cout << "重新计算：平均每批 " << fullMs / batches << " ms（加速 " << setprecision(1) << fullMs / max(repairMs, 1e-9)
+         << " 倍），" << (allSame ? "结果一致" : "结果不一致！") << "\n\n";
+}
+
+// 导入边表并写出二进制CSR文件
+void importCommand(const string& in, const string& out, bool directed, int threads) {
+    ThreadPool pool(threads);
+    auto t0 = chrono::steady_clock::now();
+    CSRGraph g = importEdgeList(in, directed, pool);
+    auto t1 = chrono::steady_clock::now();
+    g.save(out);
+    auto t2 = chrono::steady_clock::now();
+    cout << fixed << setprecision(2);
+    cout << "导入 " << in << "：" << g.numVertices() << " 个顶点，" << g.numArcs() << " 条弧，"
+         << chrono::duration<double, milli>(t1 - t0).count() << " ms（" << threads << " 个线程）\n";
+    cout << "写出 " << out << "：" << chrono::duration<double, milli>(t2 - t1).count() << " ms\n";
+}
+
+// 映射CSR文件并立即做一次BFS，展示加载耗时与可用性
+void csrInfoCommand(const string& path) {
+    auto t0 = chrono::steady_clock::now();
+    CSRGraph g = CSRGraph::mapFile(path);
+    g.validate();
+    auto t1 = chrono::steady_clock::now();
+    cout << fixed << setprecision(3);
+    cout << path << "：" << (g.isDirected() ? "有向" : "无向") << "图，" << g.numVertices() << " 个顶点，"
+         << g.numArcs() << " 条弧，映射与校验耗时 " << chrono::duration<double, milli>(t1 - t0).count() << " ms\n";
+    if (g.numVertices() == 0) return;
+    ThreadPool pool(max(1u, thread::hardware_concurrency()));
+    ParallelBFS bfs(g, pool);
+    BFSResult r = bfs.run(0);
+    auto t2 = chrono::steady_clock::now();
+    int depth = 0;
+    for (int l : r.level) depth = max(depth, l);
+    cout << "从顶点0出发BFS：可达 " << r.order.size() << " 个顶点，最大层数 " << depth << "，耗时 "
+         << chrono::duration<double, milli>(t2 - t1).count() << " ms\n";
+}
+
+void printUsage(const char* prog) {
+    cout << "用法：\n";
+    cout << "  " << prog << "                                                运行图算法演示\n";
+    cout << "  " << prog << " ch-bench [网格边长] [道路图顶点数] [查询数]      CH与Dijkstra查询延迟对比\n";
+    cout << "  " << prog << " sssp-bench [网格边长] [线程数] [delta] [源点数]  并行delta-stepping与多源批量\n";
+    cout << "  " << prog << " mst-bench [网格边长] [线程数]                    Prim/Kruskal/Borůvka对比\n";
+    cout << "  " << prog << " bfs-bench [顶点数] [线程数]                      确定性BFS与方向优化并行BFS对比\n";
+    cout << "  " << prog << " dyn-bench [网格边长] [批数] [每批更新数]        动态改权下增量最短路与重新计算对比\n";
+    cout << "  " << prog << " import <边表> <输出.csr> [有向=0] [线程数]       导入文本/CSV边表，写出二进制CSR\n";
+    cout << "  " << prog << " csr-info <文件.csr>                              映射二进制CSR并做一次BFS\n";
+}
+
+// 命令行入口，返回进程退出码
+int runCli(int argc, char* argv[]) {
+    string cmd = argv[1];
+    try {
+        if (cmd == "ch-bench") {
+            int side = argc >= 3 ? stoi(argv[2]) : 200;
+            int roadN = argc >= 4 ? stoi(argv[3]) : 50000;
+            int queries = argc >= 5 ? stoi(argv[4]) : 1000;
+            benchmarkCH("网格图", buildGridGraph(side, side, 2025), queries);
+            benchmarkCH("类道路图", buildRoadLikeGraph(roadN, 2025), queries);
+        } else if (cmd == "sssp-bench") {
+            int side = argc >= 3 ? stoi(argv[2]) : 500;
+            int threads = argc >= 4 ? stoi(argv[3]) : max(1u, thread::hardware_concurrency());
+            Dist delta = argc >= 5 ? stoll(argv[4]) : 0;
+            int sources = argc >= 6 ? stoi(argv[5]) : 32;
+            benchmarkParallelSSSP(buildGridGraph(side, side, 2025), threads, delta, sources);
+            benchmarkParallelSSSP(buildRoadLikeGraph(side * side, 2025), threads, delta, sources);
+        } else if (cmd == "mst-bench") {
+            int side = argc >= 3 ? stoi(argv[2]) : 1000;
+            int threads = argc >= 4 ? stoi(argv[3]) : max(1u, thread::hardware_concurrency());
+            benchmarkMST("网格图", buildGridGraph(side, side, 2025), threads);
+            benchmarkMST("类道路图（可能不连通）", buildRoadLikeGraph(side * side, 2025), threads);
+        } else if (cmd == "dyn-bench") {
+            int side = argc >= 3 ? stoi(argv[2]) : 300;
+            int batches = argc >= 4 ? stoi(argv[3]) : 20;
+            int batchSize = argc >= 5 ? stoi(argv[4]) : 100;
+            benchmarkDynamicSSSP(buildGridGraph(side, side, 2025), batches, batchSize);
+            benchmarkDynamicSSSP(buildRoadLikeGraph(side * side, 2025), batches, batchSize);
+        } else if (cmd == "import" && argc >= 4) {
+            bool directed = argc >= 5 && stoi(argv[4]) != 0;
+            int threads = argc >= 6 ? stoi(argv[5]) : max(1u, thread::hardware_concurrency());
+            importCommand(argv[2], argv[3], directed, threads);
+        } else if (cmd == "csr-info" && argc >= 3) {
+            csrInfoCommand(argv[2]);
+        } else if (cmd == "bfs-bench") {
+            int n = argc >= 3 ? stoi(argv[2]) : 1000000;
+            int threads = argc >= 4 ? stoi(argv[3]) : max(1u, thread::hardware_concurrency());
+            benchmarkBFS("幂律图", buildPowerLawGraph(n, 8, 2025), threads);
+            int side = max(1, (int)sqrt((double)n));
+            benchmarkBFS("网格图", buildGridGraph(side, side, 2025), threads);
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    } catch (const exception& e) {
+        cerr << "错误: " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
+
 // ============================== 主函数 ==============================
-int main() {
+int main(int argc, char* argv[]) {
+    if (argc > 1) return runCli(argc, argv);
+
     cout << "==================== 任务1：图1的邻接矩阵 ====================\n";
     Graph graph1 = buildGraph1();
     graph1.printAdjMatrix();
@@ -349,23 +3012,87 @@ int main() {
     vector<char> dfsOrder = DFS(graph1, 'A');
     cout << "DFS遍历顺序：";
     for (char v : dfsOrder) cout << v << " ";
+    cout << "\n";
+
+    // 有向依赖图：边u->v表示u先于v
+    Graph deps({'A', 'B', 'C', 'D', 'E', 'F'}, true);
+    deps.addEdge('A', 'B', 1);
+    deps.addEdge('A', 'C', 1);
+    deps.addEdge('B', 'D', 1);
+    deps.addEdge('C', 'D', 1);
+    deps.addEdge('D', 'E', 1);
+    deps.addEdge('F', 'E', 1);
+    cout << "依赖图拓扑序：";
+    for (char v : topologicalSort(deps)) cout << v << " ";
+    cout << "\n";
+    deps.addEdge('E', 'B', 1);
+    SCCResult scc = stronglyConnectedComponents(deps.csr());
+    cout << "加入E->B后的强连通分量（" << scc.count << "个）：";
+    for (int c = 0; c < scc.count; ++c) {
+        cout << "{ ";
+        for (VertexId v = 0; v < deps.numVertices(); ++v) {
+            if (scc.comp[v] == c) cout << deps.label(v) << " ";
+        }
+        cout << "} ";
+    }
     cout << "\n\n";
 
     cout << "==================== 任务3：图1的最短路径和最小支撑树（起点A） ====================\n";
-    pair<map<char, int>, map<char, char>> dijkstraRes = Dijkstra(graph1, 'A');
-    map<char, int> dist = dijkstraRes.first;
+    pair<map<char, Dist>, map<char, char>> dijkstraRes = Dijkstra(graph1, 'A');
+    map<char, Dist> dist = dijkstraRes.first;
     map<char, char> prev = dijkstraRes.second;
     cout << "各顶点到A的最短距离：\n";
     for (auto& p : dist) {
         char v = p.first;
-        int d = p.second;
-        cout << "A到" << v << "：" << (d == INT_MAX ? "无路径" : to_string(d)) << "\n";
-        if (d != INT_MAX) printDijkstraPath(prev, 'A', v);
+        Dist d = p.second;
+        cout << "A到" << v << "：" << (d == INF_DIST ? "无路径" : to_string(d)) << "\n";
+        if (d != INF_DIST) printDijkstraPath(prev, 'A', v);
+    }
+
+    cout << "\n点对点查询 A->L（到达即停止）：\n";
+    const char* heapNames[] = {"二叉堆", "四叉堆", "基数堆"};
+    HeapKind kinds[] = {HeapKind::Binary, HeapKind::Quaternary, HeapKind::Radix};
+    for (int k = 0; k < 3; ++k) {
+        vector<VertexId> path;
+        Dist d = shortestPath(graph1.csr(), graph1.id('A'), graph1.id('L'), path, kinds[k]);
+        cout << heapNames[k] << "：距离 " << d << "，路径 ";
+        for (size_t i = 0; i < path.size(); ++i) {
+            cout << (i > 0 ? "->" : "") << graph1.label(path[i]);
+        }
+        cout << "\n";
+    }
+
+    BidirectionalDijkstra<> bidi(graph1.csr());
+    PathResult biRes = bidi.query(graph1.id('A'), graph1.id('L'));
+    cout << "双向Dijkstra：距离 " << biRes.dist << "，路径 ";
+    for (size_t i = 0; i < biRes.path.size(); ++i) {
+        cout << (i > 0 ? "->" : "") << graph1.label(biRes.path[i]);
     }
+    cout << "\n";
+
+    // 网格图上比较各种点对点搜索的搜索空间（出堆顶点数）
+    vector<double> xs, ys;
+    CSRGraph grid = buildGridGraph(200, 200, 2025, &xs, &ys);
+    VertexId gs = 50 * 200 + 30, gt = 150 * 200 + 160;
+    DijkstraEngine<BinaryHeap> plain(grid);
+    Dist plainDist = plain.run(gs, gt);
+    BidirectionalDijkstra<> gridBidi(grid);
+    PathResult gb = gridBidi.query(gs, gt);
+    EuclideanHeuristic euclid(xs, ys, 10.0);
+    AStarEngine<EuclideanHeuristic> astar(grid, euclid);
+    PathResult ga = astar.query(gs, gt);
+    LandmarkHeuristic alt(grid, 8);
+    AStarEngine<LandmarkHeuristic> altEngine(grid, alt);
+    PathResult gl = altEngine.query(gs, gt);
+    cout << "\n200×200网格图 (30,50)->(160,150)：\n";
+    cout << "Dijkstra（提前结束）：距离 " << plainDist << "，出堆 " << plain.settledCount() << " 个顶点\n";
+    cout << "双向Dijkstra：        距离 " << gb.dist << "，出堆 " << gb.settled << " 个顶点\n";
+    cout << "A*（坐标）：          距离 " << ga.dist << "，出堆 " << ga.settled << " 个顶点\n";
+    cout << "A*（8个地标ALT）：    距离 " << gl.dist << "，出堆 " << gl.settled << " 个顶点\n";
 
-    pair<vector<tuple<char, char, int>>, int> primRes = Prim(graph1, 'A');
+    pair<vector<tuple<char, char, int>>, Dist> primRes = Prim(graph1, 'A');
     vector<tuple<char, char, int>> mstEdges = primRes.first;
-    int totalWeight = primRes.second;
+    Dist totalWeight = primRes.second;
     cout << "\n最小支撑树（MST）：\n";
     cout << "总权重：" << totalWeight << "\n";
     cout << "边集合：";
@@ -385,8 +3112,15 @@ int main() {
         set<char> aps = tarjanRes.second;
         printBCC(bcc);
         printArticulationPoints(aps);
-        cout << "\n";
+        cout << "桥：";
+        for (auto& e : tarjan.bridges()) cout << "(" << e.first << "," << e.second << ") ";
+        cout << "\n\n";
     }
 
+    BiconnectedResult bccRes = biconnectedComponents(graph2.csr());
+    BlockCutTree bct = buildBlockCutTree(graph2.csr(), bccRes);
+    cout << "块-割点树：" << bct.numBlocks << " 个块，" << bct.cutVertex.size() << " 个割点，"
+         << bct.tree.numArcs() / 2 << " 条树边\n";
+
     return 0;
 }
\ No newline at end of file
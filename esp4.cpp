@@ -5,6 +5,23 @@
 #include <algorithm>
 #include <iomanip>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <string>
+#include "datagen.h"
+#include "perfmon.h"
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
 
 using namespace std;
 
@@ -16,28 +33,113 @@ struct BoundingBox {
 };
 
 // -------------------------- 排序算法实现 --------------------------
-// 1. 快速排序（递归版，按置信度降序）
-int partition(vector<BoundingBox>& arr, int low, int high) {
-    float pivot = arr[high].score;
-    int i = low - 1;
-    for (int j = low; j < high; j++) {
-        if (arr[j].score >= pivot) { // 降序排列
-            i++;
-            swap(arr[i], arr[j]);
+// 以下内省排序的各部件为模板，元素只需有score成员（BoundingBox或下文的ScoreIndex）
+// 三路划分[lo, hi)（降序）：返回[lt, gt)，其中[lo,lt)置信度大于pivot，[lt,gt)等于，[gt,hi)小于
+template <typename T>
+pair<int, int> partition3(vector<T>& arr, int lo, int hi, float pivot) {
+    int lt = lo, i = lo, gt = hi;
+    while (i < gt) {
+        if (arr[i].score > pivot) swap(arr[lt++], arr[i++]);
+        else if (arr[i].score < pivot) swap(arr[i], arr[--gt]);
+        else i++;
+    }
+    return make_pair(lt, gt);
+}
+
+// 插入排序[lo, hi)（降序），用于小区间
+template <typename T>
+void insertionSortRange(vector<T>& arr, int lo, int hi) {
+    for (int i = lo + 1; i < hi; i++) {
+        T cur = arr[i];
+        int j = i - 1;
+        while (j >= lo && arr[j].score < cur.score) {
+            arr[j + 1] = arr[j];
+            j--;
         }
+        arr[j + 1] = cur;
     }
-    swap(arr[i + 1], arr[high]);
-    return i + 1;
 }
 
-void quickSort(vector<BoundingBox>& arr, int low, int high) {
-    if (low < high) {
-        int pi = partition(arr, low, high);
-        quickSort(arr, low, pi - 1);
-        quickSort(arr, pi + 1, high);
+// 有限插入排序：元素移动超过limit次即放弃（区间仍是原数据的一个排列），完成排序时返回true。
+// 对已有序或接近有序的区间可以O(n)结束，随机数据上很快放弃
+template <typename T>
+bool partialInsertionSort(vector<T>& arr, int lo, int hi, int limit = 8) {
+    int moves = 0;
+    for (int i = lo + 1; i < hi; i++) {
+        if (arr[i - 1].score >= arr[i].score) continue;
+        T cur = arr[i];
+        int j = i - 1;
+        while (j >= lo && arr[j].score < cur.score) {
+            arr[j + 1] = arr[j];
+            j--;
+        }
+        arr[j + 1] = cur;
+        moves += i - 1 - j;
+        if (moves > limit) return false;
+    }
+    return true;
+}
+
+// 堆排序[lo, hi)（降序，内省排序的回退，保证最坏O(n log n)）
+template <typename T>
+void heapSortRange(vector<T>& arr, int lo, int hi) {
+    auto greater = [](const T& a, const T& b) { return a.score > b.score; };
+    make_heap(arr.begin() + lo, arr.begin() + hi, greater);
+    sort_heap(arr.begin() + lo, arr.begin() + hi, greater);
+}
+
+// 三个置信度的中位数
+float median3(float a, float b, float c) {
+    return max(min(a, b), min(max(a, b), c));
+}
+
+// 枢轴：小区间三数取中，大区间用Tukey九数取中（ninther）
+template <typename T>
+float choosePivot(const vector<T>& arr, int lo, int hi) {
+    int n = hi - lo, mid = lo + n / 2;
+    if (n < 128) return median3(arr[lo].score, arr[mid].score, arr[hi - 1].score);
+    int s = n / 8;
+    return median3(median3(arr[lo].score, arr[lo + s].score, arr[lo + 2 * s].score),
+                   median3(arr[mid - s].score, arr[mid].score, arr[mid + s].score),
+                   median3(arr[hi - 1 - 2 * s].score, arr[hi - 1 - s].score, arr[hi - 1].score));
+}
+
+// 1. 快速排序（内省排序，按置信度降序）：
+//   九数取中枢轴 + 三路划分（大量相同置信度时不退化），区间<=24时插入排序，
+//   划分前先尝试有限插入排序（已有序/接近有序的输入线性结束），
+//   划分深度超过2log2(n)时改用堆排序；显式栈，较大一侧入栈、先处理较小一侧，栈深不超过log2(n)
+template <typename T>
+void introSort(vector<T>& arr, int lo, int hi) {
+    struct Frame {
+        int lo, hi, depth;
+    };
+    const int smallRange = 24;
+    vector<Frame> stk;
+    stk.reserve(64);
+    if (hi - lo > 1) stk.push_back({lo, hi, 2 * (int)log2((double)(hi - lo))});
+    while (!stk.empty()) {
+        Frame f = stk.back();
+        stk.pop_back();
+        while (f.hi - f.lo > smallRange) {
+            if (partialInsertionSort(arr, f.lo, f.hi)) break;
+            if (f.depth-- == 0) {
+                heapSortRange(arr, f.lo, f.hi);
+                break;
+            }
+            pair<int, int> p = partition3(arr, f.lo, f.hi, choosePivot(arr, f.lo, f.hi));
+            Frame left = {f.lo, p.first, f.depth}, right = {p.second, f.hi, f.depth};
+            if (left.hi - left.lo > right.hi - right.lo) swap(left, right);
+            stk.push_back(right); // 较大一侧入栈
+            f = left;
+        }
+        if (f.hi - f.lo <= smallRange) insertionSortRange(arr, f.lo, f.hi);
     }
 }
 
+void quickSort(vector<BoundingBox>& arr, int low, int high) {
+    if (low < high) introSort(arr, low, high + 1);
+}
+
 // 2. 冒泡排序（按置信度降序）
 void bubbleSort(vector<BoundingBox>& arr) {
     int n = arr.size();
@@ -86,6 +188,7 @@ void merge(vector<BoundingBox>& arr, int left, int mid, int right) {
 }
 
 void mergeSort(vector<BoundingBox>& arr, int left, int right) {
+    PERF_SCOPE_TOP("esp4_merge_sort");
     if (left < right) {
         int mid = left + (right - left) / 2;
         mergeSort(arr, left, mid);
@@ -94,54 +197,183 @@ void mergeSort(vector<BoundingBox>& arr, int left, int right) {
     }
 }
 
+// 5. 基数排序（LSD，按置信度降序，稳定）
+// 浮点数 -> 保序的32位无符号键：非负数翻转符号位，负数按位取反；-0.0按+0.0处理
+inline uint32_t floatKey(float f) {
+    if (f == 0.0f) f = 0.0f;
+    uint32_t u;
+    memcpy(&u, &f, sizeof(u));
+    return (u & 0x80000000u) ? ~u : (u | 0x80000000u);
+}
+
+// 键+原下标，排序时只移动这8字节
+struct KeyIndex {
+    uint32_t key;
+    uint32_t idx;
+};
+
+const int RADIX_BITS = 11;                  // 每趟11位，32位键共3趟
+const int RADIX_SIZE = 1 << RADIX_BITS;
+const int RADIX_PASSES = (32 + RADIX_BITS - 1) / RADIX_BITS;
+
+inline uint32_t radixDigit(uint32_t key, int pass) {
+    return (key >> (pass * RADIX_BITS)) & (RADIX_SIZE - 1);
+}
+
+// 对KeyIndex数组按key升序做LSD基数排序（稳定），结果留在a中，b为同长度的乒乓缓冲。
+// threads==1：一趟遍历同时统计3个数位的直方图，然后逐趟分发；
+// threads>1：每趟把数组分成threads段并行统计各段直方图，按(数位, 段号)求前缀和得到各段的写入位置，
+//            再并行分发，段间顺序保持不变，因此仍然稳定。
+// 某一数位上所有键都相同时（置信度在[0,1]内高位基本不变）跳过该趟。
+void radixSortKeys(vector<KeyIndex>& a, vector<KeyIndex>& b, int threads = 1) {
+    size_t n = a.size();
+    if (n < 2) return;
+    threads = max(1, min(threads, (int)(n / 65536) + 1));
+    if (threads == 1) {
+        vector<size_t> hist((size_t)RADIX_PASSES * RADIX_SIZE, 0);
+        for (const KeyIndex& e : a) {
+            for (int p = 0; p < RADIX_PASSES; p++) hist[(size_t)p * RADIX_SIZE + radixDigit(e.key, p)]++;
+        }
+        for (int p = 0; p < RADIX_PASSES; p++) {
+            size_t* h = &hist[(size_t)p * RADIX_SIZE];
+            if (h[radixDigit(a[0].key, p)] == n) continue;
+            size_t sum = 0;
+            for (int d = 0; d < RADIX_SIZE; d++) {
+                size_t c = h[d];
+                h[d] = sum;
+                sum += c;
+            }
+            for (const KeyIndex& e : a) b[h[radixDigit(e.key, p)]++] = e;
+            a.swap(b);
+        }
+        return;
+    }
+
+    vector<size_t> hist((size_t)threads * RADIX_SIZE);
+    vector<thread> workers;
+    auto runParallel = [&](auto fn) {
+        workers.clear();
+        for (int t = 1; t < threads; t++) workers.emplace_back(fn, t);
+        fn(0);
+        for (thread& w : workers) w.join();
+    };
+    for (int p = 0; p < RADIX_PASSES; p++) {
+        fill(hist.begin(), hist.end(), 0);
+        runParallel([&](int t) {
+            size_t* h = &hist[(size_t)t * RADIX_SIZE];
+            for (size_t i = n * t / threads; i < n * (t + 1) / threads; i++) h[radixDigit(a[i].key, p)]++;
+        });
+        // 前缀和：数位为主序、段号为次序
+        size_t sum = 0;
+        bool skip = false;
+        for (int d = 0; d < RADIX_SIZE && !skip; d++) {
+            size_t digitTotal = 0;
+            for (int t = 0; t < threads; t++) {
+                size_t c = hist[(size_t)t * RADIX_SIZE + d];
+                hist[(size_t)t * RADIX_SIZE + d] = sum;
+                sum += c;
+                digitTotal += c;
+            }
+            skip = digitTotal == n;
+        }
+        if (skip) continue;
+        runParallel([&](int t) {
+            size_t* h = &hist[(size_t)t * RADIX_SIZE];
+            for (size_t i = n * t / threads; i < n * (t + 1) / threads; i++) b[h[radixDigit(a[i].key, p)]++] = a[i];
+        });
+        a.swap(b);
+    }
+}
+
+// 按置信度降序的稳定排列：perm[i]为排序后第i个框在原数组中的下标（原数组不动）
+vector<uint32_t> radixSortIndices(const vector<BoundingBox>& arr, int threads = 1) {
+    size_t n = arr.size();
+    vector<KeyIndex> a(n), b(n);
+    for (size_t i = 0; i < n; i++) a[i] = KeyIndex{~floatKey(arr[i].score), (uint32_t)i}; // 取反得到降序
+    radixSortKeys(a, b, threads);
+    vector<uint32_t> perm(n);
+    for (size_t i = 0; i < n; i++) perm[i] = a[i].idx;
+    return perm;
+}
+
+// 基数排序整个数组：先对键排序，再按排列一次性搬运边界框
+void radixSort(vector<BoundingBox>& arr, int threads = 1) {
+    vector<uint32_t> perm = radixSortIndices(arr, threads);
+    vector<BoundingBox> out(arr.size());
+    for (size_t i = 0; i < perm.size(); i++) out[i] = arr[perm[i]];
+    arr.swap(out);
+}
+
+// 6. 键-下标排序：只对(置信度, 下标)对排序，边界框本身不动或最后只搬运一次
+struct ScoreIndex {
+    float score;
+    uint32_t idx;
+};
+
+// 按置信度降序的排列（内省排序作用于8字节的ScoreIndex，而不是20字节的BoundingBox）
+vector<uint32_t> sortIndicesByScore(const vector<BoundingBox>& arr) {
+    vector<ScoreIndex> keys(arr.size());
+    for (size_t i = 0; i < arr.size(); i++) keys[i] = ScoreIndex{arr[i].score, (uint32_t)i};
+    introSort(keys, 0, keys.size());
+    vector<uint32_t> perm(keys.size());
+    for (size_t i = 0; i < keys.size(); i++) perm[i] = keys[i].idx;
+    return perm;
+}
+
+// 按排列一次性重排：out[i] = arr[perm[i]]
+void applyPermutation(vector<BoundingBox>& arr, const vector<uint32_t>& perm) {
+    vector<BoundingBox> out(perm.size());
+    for (size_t i = 0; i < perm.size(); i++) out[i] = arr[perm[i]];
+    arr.swap(out);
+}
+
+void keyIndexSort(vector<BoundingBox>& arr) {
+    applyPermutation(arr, sortIndicesByScore(arr));
+}
+
 // -------------------------- 数据生成模块 --------------------------
+// 生成器基于datagen.h的xoshiro256**：同一种子得到相同数据，大规模数据按子流并行生成
+// 未指定种子时依次取datagen::nextSeed()，整个实验在默认种子（或DATAGEN_SEED）下可复现
+
 // 随机分布数据生成（边界框位置、大小、置信度均随机，范围合理）
-vector<BoundingBox> generateRandomData(int size) {
-    vector<BoundingBox> data;
-    srand(time(0)); // 随机种子
-    for (int i = 0; i < size; i++) {
-        BoundingBox box;
+vector<BoundingBox> generateRandomData(int size, uint64_t seed = datagen::nextSeed()) {
+    vector<BoundingBox> data(size);
+    datagen::generateParallel(size, seed, max(1u, thread::hardware_concurrency()), [&](datagen::Rng& rng, size_t i) {
+        BoundingBox& box = data[i];
         // 位置：x1 ∈ [0, 800), y1 ∈ [0, 600)（模拟800x600图像）
-        box.x1 = rand() % 800;
-        box.y1 = rand() % 600;
+        box.x1 = rng.range(0, 799);
+        box.y1 = rng.range(0, 599);
         // 大小：宽度 ∈ [20, 100], 高度 ∈ [20, 100]
-        float w = 20 + rand() % 81;
-        float h = 20 + rand() % 81;
+        float w = rng.range(20, 100);
+        float h = rng.range(20, 100);
         box.x2 = box.x1 + w;
         box.y2 = box.y1 + h;
         // 置信度 ∈ [0.0, 1.0]
-        box.score = (rand() % 1001) / 1000.0f;
-        data.push_back(box);
-    }
+        box.score = rng.range(0, 1000) / 1000.0f;
+    });
     return data;
 }
 
 // 聚集分布数据生成（边界框集中在图像中心区域，置信度呈正态分布）
-vector<BoundingBox> generateClusteredData(int size) {
-    vector<BoundingBox> data;
-    srand(time(0));
+vector<BoundingBox> generateClusteredData(int size, uint64_t seed = datagen::nextSeed()) {
+    vector<BoundingBox> data(size);
     // 聚集中心：(400, 300)（800x600图像中心）
     const float centerX = 400.0f;
     const float centerY = 300.0f;
-    for (int i = 0; i < size; i++) {
-        BoundingBox box;
+    datagen::generateParallel(size, seed, max(1u, thread::hardware_concurrency()), [&](datagen::Rng& rng, size_t i) {
+        BoundingBox& box = data[i];
         // 位置：围绕中心±50范围内波动（聚集特性）
-        box.x1 = centerX - 50 + rand() % 101;
-        box.y1 = centerY - 50 + rand() % 101;
+        box.x1 = centerX - 50 + rng.range(0, 100);
+        box.y1 = centerY - 50 + rng.range(0, 100);
         // 大小：与随机分布一致
-        float w = 20 + rand() % 81;
-        float h = 20 + rand() % 81;
+        float w = rng.range(20, 100);
+        float h = rng.range(20, 100);
         box.x2 = box.x1 + w;
         box.y2 = box.y1 + h;
         // 置信度：正态分布（均值0.7，标准差0.15），截断到[0.0, 1.0]
-        float mu = 0.7f, sigma = 0.15f;
-        float u1 = (rand() % 1001) / 1000.0f;
-        float u2 = (rand() % 1001) / 1000.0f;
-        float z = sqrt(-2.0f * log(u1)) * cos(2.0f * M_PI * u2);
-        float score = mu + sigma * z;
+        float score = rng.normal(0.7, 0.15);
         box.score = max(0.0f, min(1.0f, score));
-        data.push_back(box);
-    }
+    });
     return data;
 }
 
@@ -165,48 +397,850 @@ float calculateIoU(const BoundingBox& a, const BoundingBox& b) {
     return interArea / unionArea;
 }
 
-// 基础NMS算法（输入排序后的边界框，IoU阈值默认0.5）
-vector<BoundingBox> nms(const vector<BoundingBox>& sortedBoxes, float iouThreshold = 0.5f) {
-    vector<BoundingBox> result;
-    vector<bool> suppressed(sortedBoxes.size(), false);
+// 基础NMS算法（输入排序后的边界框；maxOutput>0时保留满maxOutput个框即提前结束）
+// 结果写入result，suppressed为抑制标记的临时缓冲；两者由调用方持有，可在多次调用之间复用（如流水线的帧缓冲）
+void nms(const vector<BoundingBox>& sortedBoxes, vector<BoundingBox>& result, vector<char>& suppressed,
+         float iouThreshold, int maxOutput) {
+    PERF_SCOPE("esp4_nms");
+    PERF_COUNT("esp4_nms_input_boxes", sortedBoxes.size());
+    result.clear();
+    suppressed.assign(sortedBoxes.size(), 0);
     
     for (int i = 0; i < sortedBoxes.size(); i++) {
         if (suppressed[i]) continue;
         // 保留当前置信度最高的框
         result.push_back(sortedBoxes[i]);
+        if ((int)result.size() == maxOutput) break;
         // 抑制与当前框IoU超过阈值的框
         for (int j = i + 1; j < sortedBoxes.size(); j++) {
             if (suppressed[j]) continue;
             float iou = calculateIoU(sortedBoxes[i], sortedBoxes[j]);
             if (iou >= iouThreshold) {
-                suppressed[j] = true;
+                suppressed[j] = 1;
+            }
+        }
+    }
+    PERF_COUNT("esp4_nms_kept_boxes", result.size());
+}
+
+// IoU阈值默认0.5
+vector<BoundingBox> nms(const vector<BoundingBox>& sortedBoxes, float iouThreshold = 0.5f, int maxOutput = 0) {
+    vector<BoundingBox> result;
+    vector<char> suppressed;
+    nms(sortedBoxes, result, suppressed, iouThreshold, maxOutput);
+    return result;
+}
+
+// 按排列做NMS：order为按置信度降序的下标（如sortIndicesByScore/radixSortIndices的结果），
+// 边界框无需重排，结果与nms(按order重排后的数组)相同
+vector<BoundingBox> nmsIndexed(const vector<BoundingBox>& boxes, const vector<uint32_t>& order,
+                               float iouThreshold = 0.5f, int maxOutput = 0) {
+    vector<BoundingBox> result;
+    vector<bool> suppressed(order.size(), false);
+    for (size_t i = 0; i < order.size(); i++) {
+        if (suppressed[i]) continue;
+        const BoundingBox& top = boxes[order[i]];
+        result.push_back(top);
+        if ((int)result.size() == maxOutput) break;
+        for (size_t j = i + 1; j < order.size(); j++) {
+            if (!suppressed[j] && calculateIoU(top, boxes[order[j]]) >= iouThreshold) suppressed[j] = true;
+        }
+    }
+    return result;
+}
+
+// 网格加速NMS：结果与nms完全相同。
+// 等价表述：按置信度顺序，一个框被保留当且仅当它与此前所有保留框的IoU都低于阈值。
+// IoU >= 阈值(>0) 要求两框面积严格相交，因此只需检查与当前框落在相同网格单元中的保留框。
+// 保留框按覆盖的单元登记；覆盖单元过多的大框放入单独列表，始终参与检查。
+vector<BoundingBox> nmsGrid(const vector<BoundingBox>& sortedBoxes, float iouThreshold = 0.5f) {
+    int n = sortedBoxes.size();
+    if (n == 0) return vector<BoundingBox>();
+    if (!(iouThreshold > 0.0f)) return nms(sortedBoxes, iouThreshold); // 阈值<=0时不相交的框也会互相抑制
+
+    // 画面范围与平均框尺寸（只统计有效框）
+    float minX = INFINITY, minY = INFINITY, maxX = -INFINITY, maxY = -INFINITY;
+    double sumW = 0, sumH = 0;
+    int valid = 0;
+    for (const BoundingBox& b : sortedBoxes) {
+        if (!(b.x2 > b.x1 && b.y2 > b.y1)) continue;
+        minX = min(minX, b.x1);
+        minY = min(minY, b.y1);
+        maxX = max(maxX, b.x2);
+        maxY = max(maxY, b.y2);
+        sumW += b.x2 - b.x1;
+        sumH += b.y2 - b.y1;
+        valid++;
+    }
+    if (valid == 0 || !isfinite(minX) || !isfinite(minY) || !isfinite(maxX) || !isfinite(maxY)) {
+        return nms(sortedBoxes, iouThreshold);
+    }
+
+    // 单元边长取平均框尺寸（典型框覆盖不超过4个单元），单元总数不超过4n
+    double cell = max(max(sumW, sumH) / valid, 1e-6);
+    double spanX = (double)maxX - minX, spanY = (double)maxY - minY;
+    while ((spanX / cell + 1) * (spanY / cell + 1) > 4.0 * n + 16) cell *= 2;
+    int gx = (int)(spanX / cell) + 1;
+    int gy = (int)(spanY / cell) + 1;
+    auto cellX = [&](float x) { return min(gx - 1, max(0, (int)((x - minX) / cell))); };
+    auto cellY = [&](float y) { return min(gy - 1, max(0, (int)((y - minY) / cell))); };
+    const int largeCells = 16;
+
+    vector<vector<int>> cells((size_t)gx * gy);
+    vector<int> large;             // 覆盖单元过多的保留框
+    vector<int> checked(n, -1);    // 去重：保留框k最近一次被哪个候选检查过
+    vector<BoundingBox> result;
+
+    for (int j = 0; j < n; j++) {
+        const BoundingBox& b = sortedBoxes[j];
+        bool suppressed = false;
+        bool hasArea = b.x2 > b.x1 && b.y2 > b.y1; // 无面积的框不与任何框相交，必然保留
+        int cx1 = 0, cx2 = -1, cy1 = 0, cy2 = -1;
+        if (hasArea) {
+            cx1 = cellX(b.x1), cx2 = cellX(b.x2);
+            cy1 = cellY(b.y1), cy2 = cellY(b.y2);
+        }
+        auto test = [&](int k) {
+            if (checked[k] == j) return false;
+            checked[k] = j;
+            return calculateIoU(sortedBoxes[k], b) >= iouThreshold;
+        };
+        for (int k : large) {
+            if (test(k)) { suppressed = true; break; }
+        }
+        for (int y = cy1; y <= cy2 && !suppressed; y++) {
+            for (int x = cx1; x <= cx2 && !suppressed; x++) {
+                for (int k : cells[(size_t)y * gx + x]) {
+                    if (test(k)) { suppressed = true; break; }
+                }
+            }
+        }
+        if (suppressed) continue;
+
+        result.push_back(b);
+        if (!hasArea) continue;
+        if ((cx2 - cx1 + 1) * (cy2 - cy1 + 1) > largeCells) {
+            large.push_back(j);
+        } else {
+            for (int y = cy1; y <= cy2; y++) {
+                for (int x = cx1; x <= cx2; x++) cells[(size_t)y * gx + x].push_back(j);
             }
         }
     }
     return result;
 }
 
+// -------------------------- SoA边界框批与SIMD抑制内核 --------------------------
+// 结构数组（SoA）形式的边界框批：各字段连续存放便于向量化，面积预先算好
+struct BoxBatch {
+    vector<float> x1, y1, x2, y2, score, area;
+
+    size_t size() const { return x1.size(); }
+
+    static BoxBatch fromBoxes(const vector<BoundingBox>& boxes) {
+        BoxBatch b;
+        size_t n = boxes.size();
+        b.x1.resize(n); b.y1.resize(n); b.x2.resize(n); b.y2.resize(n);
+        b.score.resize(n); b.area.resize(n);
+        for (size_t i = 0; i < n; i++) {
+            const BoundingBox& box = boxes[i];
+            b.x1[i] = box.x1; b.y1[i] = box.y1; b.x2[i] = box.x2; b.y2[i] = box.y2;
+            b.score[i] = box.score;
+            b.area[i] = (box.x2 - box.x1) * (box.y2 - box.y1);
+        }
+        return b;
+    }
+
+    BoundingBox get(size_t i) const {
+        return BoundingBox{x1[i], y1[i], x2[i], y2[i], score[i]};
+    }
+};
+
+// 编译时选定的向量指令集（用 -mavx2 或 -march=native 编译以启用向量内核，否则为标量回退）
+const char* simdLevel() {
+#if defined(__AVX512F__)
+    return "AVX-512";
+#elif defined(__AVX2__)
+    return "AVX2";
+#else
+    return "标量";
+#endif
+}
+
+// 单个候选框的抑制判定（无除法）：交集>0 且 inter >= t * union
+inline bool suppressScalar(const BoxBatch& b, size_t i, size_t j, float thr) {
+    float iw = max(0.0f, min(b.x2[i], b.x2[j]) - max(b.x1[i], b.x1[j]));
+    float ih = max(0.0f, min(b.y2[i], b.y2[j]) - max(b.y1[i], b.y1[j]));
+    float inter = iw * ih;
+    return inter > 0.0f && inter >= thr * (b.area[i] + b.area[j] - inter);
+}
+
+// SoA NMS：输入按置信度降序，输出保留框下标。
+// 抑制状态为位图；保留框i与其后的候选框按8个（AVX2）或16个（AVX-512）一组比较，
+// 比较结果的掩码直接或进位图。候选组在位图中按组宽对齐，不会跨越64位字；整组已被抑制时跳过。
+// 与nms的差别只在于不做除法，IoU恰好落在阈值舍入边界上的框可能判定不同。
+vector<int> nmsBatch(const BoxBatch& b, float iouThreshold = 0.5f) {
+    size_t n = b.size();
+    vector<int> keep;
+    if (n == 0) return keep;
+    if (!(iouThreshold > 0.0f)) { // 阈值<=0时nms中任意两框都会互相抑制
+        keep.push_back(0);
+        return keep;
+    }
+#if defined(__AVX512F__)
+    const size_t W = 16;
+#elif defined(__AVX2__)
+    const size_t W = 8;
+#else
+    const size_t W = 1;
+#endif
+    vector<uint64_t> suppressed((n + 63) / 64, 0);
+
+    for (size_t i = 0; i < n; i++) {
+        if ((suppressed[i >> 6] >> (i & 63)) & 1) continue;
+        keep.push_back(i);
+        size_t j = i + 1;
+        for (; j < n && (j & (W - 1)); j++) { // 对齐到组边界
+            uint64_t& word = suppressed[j >> 6];
+            if (!((word >> (j & 63)) & 1) && suppressScalar(b, i, j, iouThreshold)) word |= 1ULL << (j & 63);
+        }
+#if defined(__AVX512F__)
+        const __m512 ax1 = _mm512_set1_ps(b.x1[i]), ay1 = _mm512_set1_ps(b.y1[i]);
+        const __m512 ax2 = _mm512_set1_ps(b.x2[i]), ay2 = _mm512_set1_ps(b.y2[i]);
+        const __m512 aArea = _mm512_set1_ps(b.area[i]), thr = _mm512_set1_ps(iouThreshold);
+        const __m512 zero = _mm512_setzero_ps();
+        const uint64_t groupMask = (1ULL << W) - 1;
+        for (; j + W <= n; j += W) {
+            uint64_t& word = suppressed[j >> 6];
+            if (((word >> (j & 63)) & groupMask) == groupMask) continue;
+            __m512 iw = _mm512_sub_ps(_mm512_min_ps(ax2, _mm512_loadu_ps(&b.x2[j])), _mm512_max_ps(ax1, _mm512_loadu_ps(&b.x1[j])));
+            __m512 ih = _mm512_sub_ps(_mm512_min_ps(ay2, _mm512_loadu_ps(&b.y2[j])), _mm512_max_ps(ay1, _mm512_loadu_ps(&b.y1[j])));
+            __m512 inter = _mm512_mul_ps(_mm512_max_ps(iw, zero), _mm512_max_ps(ih, zero));
+            __m512 uni = _mm512_sub_ps(_mm512_add_ps(aArea, _mm512_loadu_ps(&b.area[j])), inter);
+            __mmask16 m = _mm512_cmp_ps_mask(inter, zero, _CMP_GT_OQ) &
+                          _mm512_cmp_ps_mask(inter, _mm512_mul_ps(thr, uni), _CMP_GE_OQ);
+            word |= (uint64_t)m << (j & 63);
+        }
+#elif defined(__AVX2__)
+        const __m256 ax1 = _mm256_set1_ps(b.x1[i]), ay1 = _mm256_set1_ps(b.y1[i]);
+        const __m256 ax2 = _mm256_set1_ps(b.x2[i]), ay2 = _mm256_set1_ps(b.y2[i]);
+        const __m256 aArea = _mm256_set1_ps(b.area[i]), thr = _mm256_set1_ps(iouThreshold);
+        const __m256 zero = _mm256_setzero_ps();
+        const uint64_t groupMask = (1ULL << W) - 1;
+        for (; j + W <= n; j += W) {
+            uint64_t& word = suppressed[j >> 6];
+            if (((word >> (j & 63)) & groupMask) == groupMask) continue;
+            __m256 iw = _mm256_sub_ps(_mm256_min_ps(ax2, _mm256_loadu_ps(&b.x2[j])), _mm256_max_ps(ax1, _mm256_loadu_ps(&b.x1[j])));
+            __m256 ih = _mm256_sub_ps(_mm256_min_ps(ay2, _mm256_loadu_ps(&b.y2[j])), _mm256_max_ps(ay1, _mm256_loadu_ps(&b.y1[j])));
+            __m256 inter = _mm256_mul_ps(_mm256_max_ps(iw, zero), _mm256_max_ps(ih, zero));
+            __m256 uni = _mm256_sub_ps(_mm256_add_ps(aArea, _mm256_loadu_ps(&b.area[j])), inter);
+            __m256 cmp = _mm256_and_ps(_mm256_cmp_ps(inter, zero, _CMP_GT_OQ),
+                                       _mm256_cmp_ps(inter, _mm256_mul_ps(thr, uni), _CMP_GE_OQ));
+            word |= (uint64_t)_mm256_movemask_ps(cmp) << (j & 63);
+        }
+#endif
+        for (; j < n; j++) { // 尾部（无SIMD时即全部候选）
+            uint64_t& word = suppressed[j >> 6];
+            if (!((word >> (j & 63)) & 1) && suppressScalar(b, i, j, iouThreshold)) word |= 1ULL << (j & 63);
+        }
+    }
+    return keep;
+}
+
+// AoS接口：内部转为SoA后调用nmsBatch
+vector<BoundingBox> nmsSIMD(const vector<BoundingBox>& sortedBoxes, float iouThreshold = 0.5f) {
+    BoxBatch batch = BoxBatch::fromBoxes(sortedBoxes);
+    vector<BoundingBox> result;
+    for (int i : nmsBatch(batch, iouThreshold)) result.push_back(sortedBoxes[i]);
+    return result;
+}
+
+// -------------------------- Soft-NMS与多类别批量NMS --------------------------
+enum class SoftNMSMethod {
+    Linear,   // IoU > 阈值时 score *= (1 - IoU)
+    Gaussian  // score *= exp(-IoU² / sigma)
+};
+
+// Soft-NMS：不直接删除重叠框，而是按IoU衰减其置信度；衰减后低于scoreThreshold的框被丢弃。
+// 输入无需排序；每轮选出剩余框中置信度最高者，输出按选出顺序排列，score为衰减后的值。
+vector<BoundingBox> softNMS(const vector<BoundingBox>& boxes, SoftNMSMethod method, float iouThreshold = 0.3f,
+                            float sigma = 0.5f, float scoreThreshold = 0.001f, int maxOutput = 0) {
+    vector<BoundingBox> rest;
+    for (const BoundingBox& b : boxes) {
+        if (b.score >= scoreThreshold) rest.push_back(b);
+    }
+    vector<BoundingBox> result;
+    while (!rest.empty()) {
+        size_t best = 0;
+        for (size_t i = 1; i < rest.size(); i++) {
+            if (rest[i].score > rest[best].score) best = i;
+        }
+        BoundingBox top = rest[best];
+        result.push_back(top);
+        if ((int)result.size() == maxOutput) break;
+        rest[best] = rest.back();
+        rest.pop_back();
+
+        // 衰减其余框，顺带移除低于阈值的框
+        size_t k = 0;
+        for (size_t i = 0; i < rest.size(); i++) {
+            float iou = calculateIoU(top, rest[i]);
+            if (method == SoftNMSMethod::Linear) {
+                if (iou > iouThreshold) rest[i].score *= 1.0f - iou;
+            } else {
+                rest[i].score *= exp(-iou * iou / sigma);
+            }
+            if (rest[i].score >= scoreThreshold) rest[k++] = rest[i];
+        }
+        rest.resize(k);
+    }
+    return result;
+}
+
+// 多类别、多图批量NMS：classIds[i]/imageIds[i]为第i个框的类别和所属图像（imageIds为空时视为同一图像）。
+// 先把下标按(图像, 类别, 置信度降序)排序，使每个(图像, 类别)组连续；
+// 各组互不影响，由threads个线程通过原子计数器领取并行处理。maxPerGroup>0时每组最多保留这么多框。
+// 返回保留框的下标，按(图像, 类别, 置信度降序)排列。
+vector<int> batchedNMS(const vector<BoundingBox>& boxes, const vector<int>& classIds, const vector<int>& imageIds,
+                       float iouThreshold = 0.5f, int maxPerGroup = 0, int threads = 1) {
+    int n = boxes.size();
+    if ((int)classIds.size() != n || (!imageIds.empty() && (int)imageIds.size() != n)) {
+        throw invalid_argument("batchedNMS: 类别/图像编号数量与边界框数量不一致");
+    }
+    auto imageOf = [&](int i) { return imageIds.empty() ? 0 : imageIds[i]; };
+    vector<int> order(n);
+    for (int i = 0; i < n; i++) order[i] = i;
+    sort(order.begin(), order.end(), [&](int a, int b) {
+        if (imageOf(a) != imageOf(b)) return imageOf(a) < imageOf(b);
+        if (classIds[a] != classIds[b]) return classIds[a] < classIds[b];
+        if (boxes[a].score != boxes[b].score) return boxes[a].score > boxes[b].score;
+        return a < b;
+    });
+
+    // 分组边界
+    vector<int> groupStart;
+    for (int i = 0; i < n; i++) {
+        if (i == 0 || imageOf(order[i]) != imageOf(order[i - 1]) || classIds[order[i]] != classIds[order[i - 1]]) {
+            groupStart.push_back(i);
+        }
+    }
+    groupStart.push_back(n);
+    int groups = groupStart.size() - 1;
+
+    // 组内原地标记保留的下标，不同组写不同区间，无需加锁
+    vector<char> kept(n, 0);
+    atomic<int> nextGroup(0);
+    auto worker = [&]() {
+        vector<char> suppressed;
+        for (int g = nextGroup++; g < groups; g = nextGroup++) {
+            int b = groupStart[g], e = groupStart[g + 1], cnt = 0;
+            suppressed.assign(e - b, 0);
+            for (int i = b; i < e; i++) {
+                if (suppressed[i - b]) continue;
+                kept[i] = 1;
+                if (++cnt == maxPerGroup) break;
+                const BoundingBox& top = boxes[order[i]];
+                for (int j = i + 1; j < e; j++) {
+                    if (!suppressed[j - b] && calculateIoU(top, boxes[order[j]]) >= iouThreshold) suppressed[j - b] = 1;
+                }
+            }
+        }
+    };
+    threads = max(1, min(threads, groups));
+    vector<thread> pool;
+    for (int t = 1; t < threads; t++) pool.emplace_back(worker);
+    worker();
+    for (thread& t : pool) t.join();
+
+    vector<int> result;
+    for (int i = 0; i < n; i++) {
+        if (kept[i]) result.push_back(order[i]);
+    }
+    return result;
+}
+
+// -------------------------- NMS前处理：置信度预筛选与Top-K选择 --------------------------
+// 堆选择（introselect的回退）：把[lo,hi)中置信度最高的k个放到前k位，O(n log k)
+void heapSelect(vector<BoundingBox>& arr, int lo, int hi, int k) {
+    auto greater = [](const BoundingBox& a, const BoundingBox& b) { return a.score > b.score; };
+    auto first = arr.begin() + lo;
+    make_heap(first, first + k, greater); // 小顶堆，堆顶为当前第k大
+    for (int i = lo + k; i < hi; i++) {
+        if (arr[i].score > arr[lo].score) {
+            pop_heap(first, first + k, greater);
+            swap(arr[lo + k - 1], arr[i]);
+            push_heap(first, first + k, greater);
+        }
+    }
+}
+
+// introselect：把置信度最高的k个框放到arr前k位（前k位内部无序）。
+// 九数取中选枢轴 + 三路划分（聚集数据中大量截断为0/1的相同置信度一次即可归位），
+// 划分轮数超过2log2(n)时改用堆选择，最坏O(n log k)
+void selectTopKInPlace(vector<BoundingBox>& arr, int k) {
+    int n = arr.size();
+    if (k <= 0 || k >= n) return;
+    int lo = 0, hi = n;
+    int budget = 2 * (int)log2((double)n) + 1;
+    while (hi - lo > 1) {
+        if (budget-- == 0) {
+            heapSelect(arr, lo, hi, k - lo);
+            return;
+        }
+        pair<int, int> p = partition3(arr, lo, hi, choosePivot(arr, lo, hi));
+        if (k <= p.first) hi = p.first;        // 第k名在大于区
+        else if (k <= p.second) return;        // 第k名落在等于区，前k位已确定
+        else lo = p.second;                    // 第k名在小于区
+    }
+}
+
+// NMS前处理：丢弃置信度低于scoreThreshold的框，选出最高的k个（k<=0表示不限），只对这k个排序
+vector<BoundingBox> prefilterTopK(const vector<BoundingBox>& boxes, int k, float scoreThreshold = 0.0f) {
+    vector<BoundingBox> cand;
+    cand.reserve(boxes.size());
+    for (const BoundingBox& b : boxes) {
+        if (b.score >= scoreThreshold) cand.push_back(b);
+    }
+    if (k > 0 && k < (int)cand.size()) {
+        selectTopKInPlace(cand, k);
+        cand.resize(k);
+    }
+    if (!cand.empty()) quickSort(cand, 0, cand.size() - 1);
+    return cand;
+}
+
+// -------------------------- 多帧流式NMS流水线 --------------------------
+// 有界无锁MPMC队列（Vyukov算法）：每个槽位带序号，生产者/消费者各自CAS推进尾/头指针，容量取2的幂
+template <typename T>
+class BoundedQueue {
+private:
+    struct Cell {
+        atomic<size_t> seq;
+        T data;
+    };
+    unique_ptr<Cell[]> cells;
+    size_t mask;
+    alignas(64) atomic<size_t> head;
+    alignas(64) atomic<size_t> tail;
+
+public:
+    explicit BoundedQueue(size_t capacity) : head(0), tail(0) {
+        size_t cap = 2;
+        while (cap < capacity) cap <<= 1;
+        cells.reset(new Cell[cap]);
+        mask = cap - 1;
+        for (size_t i = 0; i < cap; i++) cells[i].seq.store(i, memory_order_relaxed);
+    }
+
+    // 队列满时返回false
+    bool tryPush(const T& v) {
+        size_t pos = tail.load(memory_order_relaxed);
+        while (true) {
+            Cell& c = cells[pos & mask];
+            intptr_t dif = (intptr_t)c.seq.load(memory_order_acquire) - (intptr_t)pos;
+            if (dif == 0) {
+                if (tail.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) {
+                    c.data = v;
+                    c.seq.store(pos + 1, memory_order_release);
+                    return true;
+                }
+            } else if (dif < 0) {
+                return false;
+            } else {
+                pos = tail.load(memory_order_relaxed);
+            }
+        }
+    }
+
+    // 队列空时返回false
+    bool tryPop(T& v) {
+        size_t pos = head.load(memory_order_relaxed);
+        while (true) {
+            Cell& c = cells[pos & mask];
+            intptr_t dif = (intptr_t)c.seq.load(memory_order_acquire) - (intptr_t)(pos + 1);
+            if (dif == 0) {
+                if (head.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) {
+                    v = c.data;
+                    c.seq.store(pos + mask + 1, memory_order_release);
+                    return true;
+                }
+            } else if (dif < 0) {
+                return false;
+            } else {
+                pos = head.load(memory_order_relaxed);
+            }
+        }
+    }
+};
+
+// 工作窃取线程池：每个工作线程有自己的双端队列，本线程派生的任务压入自己队尾并从队尾取（LIFO，缓存友好），
+// 本地为空时按FIFO取外部线程提交到公共注入队列的任务（先到的帧先处理），再从其他线程的队首窃取。
+// 各队列用各自的互斥锁保护，竞争只发生在注入和窃取时。
+class WorkStealingPool {
+private:
+    struct WorkerQueue {
+        mutex m;
+        deque<function<void()>> q;
+    };
+    vector<unique_ptr<WorkerQueue>> queues;
+    WorkerQueue injected;                   // 外部线程提交的任务
+    vector<thread> threads;
+    atomic<bool> stopping;
+    atomic<long> pending;
+    mutex sleepMtx;
+    condition_variable cv;
+    static thread_local int self;           // 当前线程的工作线程编号，外部线程为-1
+    static thread_local WorkStealingPool* owner;
+
+    static bool popFront(WorkerQueue& w, function<void()>& task) {
+        lock_guard<mutex> lock(w.m);
+        if (w.q.empty()) return false;
+        task = move(w.q.front());
+        w.q.pop_front();
+        return true;
+    }
+
+    // 取任务：自己的队尾 -> 注入队列队首 -> 其他线程的队首；外部线程i为-1，只看注入队列和窃取
+    bool take(int i, function<void()>& task) {
+        int n = queues.size();
+        if (i >= 0) {
+            WorkerQueue& w = *queues[i];
+            lock_guard<mutex> lock(w.m);
+            if (!w.q.empty()) {
+                task = move(w.q.back());
+                w.q.pop_back();
+                return true;
+            }
+        }
+        if (popFront(injected, task)) return true;
+        for (int k = 1; k <= n; k++) {
+            int victim = (max(i, 0) + k) % n;
+            if (victim != i && popFront(*queues[victim], task)) return true;
+        }
+        return false;
+    }
+
+public:
+    explicit WorkStealingPool(int n) : stopping(false), pending(0) {
+        n = max(1, n);
+        for (int i = 0; i < n; i++) queues.emplace_back(new WorkerQueue());
+        for (int i = 0; i < n; i++) {
+            threads.emplace_back([this, i]() {
+                self = i;
+                owner = this;
+                while (!stopping.load()) {
+                    if (tryRunOne()) continue;
+                    unique_lock<mutex> lock(sleepMtx);
+                    cv.wait(lock, [this]() { return stopping.load() || pending.load() > 0; });
+                }
+            });
+        }
+    }
+
+    ~WorkStealingPool() {
+        {
+            lock_guard<mutex> lock(sleepMtx);
+            stopping = true;
+        }
+        cv.notify_all();
+        for (thread& t : threads) t.join();
+    }
+
+    int size() const { return queues.size(); }
+
+    void spawn(function<void()> task) {
+        WorkerQueue& w = owner == this ? *queues[self] : injected;
+        {
+            lock_guard<mutex> lock(w.m);
+            w.q.push_back(move(task));
+        }
+        pending++;
+        { lock_guard<mutex> lock(sleepMtx); } // 与等待方的谓词检查串行化，避免丢失唤醒
+        cv.notify_one();
+    }
+
+    // 取一个任务在当前线程执行（工作线程等待下游时用来帮忙），没有任务时返回false
+    bool tryRunOne() {
+        function<void()> task;
+        if (!take(owner == this ? self : -1, task)) return false;
+        pending--;
+        task();
+        return true;
+    }
+};
+
+thread_local int WorkStealingPool::self = -1;
+thread_local WorkStealingPool* WorkStealingPool::owner = nullptr;
+
+// HDR风格延迟直方图（纳秒）：按2的幂分段，每段再线性分16格，相对误差不超过1/16；计数为原子变量，可多线程记录
+class LatencyHistogram {
+private:
+    static const int SUB = 16;
+    static const int BUCKETS = 61 * SUB;
+    atomic<uint64_t> counts[BUCKETS];
+    atomic<uint64_t> total;
+    atomic<uint64_t> maxValue;
+
+    static int bucketOf(uint64_t v) {
+        if (v < SUB) return v;
+        int e = 63 - __builtin_clzll(v);
+        return (e - 3) * SUB + ((v >> (e - 4)) & (SUB - 1));
+    }
+
+    static uint64_t bucketLow(int b) {
+        if (b < SUB) return b;
+        int e = b / SUB + 3;
+        return (uint64_t)(SUB + b % SUB) << (e - 4);
+    }
+
+public:
+    LatencyHistogram() : total(0), maxValue(0) {
+        for (auto& c : counts) c.store(0, memory_order_relaxed);
+    }
+
+    void record(uint64_t ns) {
+        counts[bucketOf(ns)].fetch_add(1, memory_order_relaxed);
+        total.fetch_add(1, memory_order_relaxed);
+        uint64_t m = maxValue.load(memory_order_relaxed);
+        while (ns > m && !maxValue.compare_exchange_weak(m, ns, memory_order_relaxed)) {}
+    }
+
+    uint64_t count() const { return total.load(); }
+    uint64_t maximum() const { return maxValue.load(); }
+
+    // 第p百分位（0~100），返回所在格的下界
+    uint64_t percentile(double p) const {
+        uint64_t n = total.load();
+        if (n == 0) return 0;
+        uint64_t rank = (uint64_t)ceil(p / 100.0 * n), seen = 0;
+        for (int b = 0; b < BUCKETS; b++) {
+            seen += counts[b].load(memory_order_relaxed);
+            if (seen >= max<uint64_t>(rank, 1)) return bucketLow(b);
+        }
+        return maxValue.load();
+    }
+};
+
+// 一帧：输入框与输出框的缓冲来自缓冲池并反复复用（clear不释放容量）
+struct PipelineFrame {
+    int stream;
+    long long seq;
+    vector<BoundingBox> boxes;     // 输入，由调用方填充
+    vector<BoundingBox> kept;      // NMS输出
+    vector<char> suppressed;       // NMS临时标记
+    chrono::steady_clock::time_point submitted, enqueued;
+};
+
+struct PipelineConfig {
+    float scoreThreshold = 0.05f; // 置信度过滤阈值
+    int topK = 1000;              // NMS前保留的候选数
+    float iouThreshold = 0.5f;
+    int maxOutput = 100;          // 每帧最多输出的框数
+    int threads = 1;
+    int frames = 64;              // 缓冲池中的帧数（即同时在途的最大帧数）
+};
+
+const int PIPELINE_STAGES = 4;
+const char* const PIPELINE_STAGE_NAMES[PIPELINE_STAGES] = {"置信度过滤", "Top-K选择", "NMS", "输出"};
+
+// 流式NMS流水线：置信度过滤 -> Top-K选择 -> NMS -> 输出，各级之间用有界无锁队列连接。
+// 帧入队某一级时向工作窃取池派生一个“处理该级一帧”的任务，因此不同帧、不同级在多线程上并发执行，
+// 慢帧只占用一个线程，不阻塞其他路的帧（无队头阻塞）。
+// 背压来自帧缓冲池：在途帧数不超过cfg.frames，池空时acquire返回空指针，由调用方丢帧或稍后重试；
+// 各级队列容量都不小于cfg.frames，因此入队不会失败。
+// 输出无序，同一路内的帧也可能乱序完成；每帧带(stream, seq)，需要按序时由调用方按seq重排。
+class NMSPipeline {
+private:
+    PipelineConfig cfg;
+    vector<unique_ptr<PipelineFrame>> storage;
+    BoundedQueue<PipelineFrame*> freeFrames;
+    vector<unique_ptr<BoundedQueue<PipelineFrame*>>> inbox;
+    BoundedQueue<PipelineFrame*> outbox;
+    LatencyHistogram waitHist[PIPELINE_STAGES], serviceHist[PIPELINE_STAGES], endToEnd;
+    atomic<long> inFlight;
+    WorkStealingPool pool; // 最后构造、最先析构：先停线程，再释放队列
+
+    static uint64_t nanosSince(chrono::steady_clock::time_point t) {
+        return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - t).count();
+    }
+
+    void process(int stage, PipelineFrame* f) {
+        vector<BoundingBox>& boxes = f->boxes;
+        if (stage == 0) {
+            boxes.erase(remove_if(boxes.begin(), boxes.end(),
+                                  [&](const BoundingBox& b) { return b.score < cfg.scoreThreshold; }),
+                        boxes.end());
+        } else if (stage == 1) {
+            if (cfg.topK > 0 && (int)boxes.size() > cfg.topK) {
+                selectTopKInPlace(boxes, cfg.topK);
+                boxes.resize(cfg.topK);
+            }
+            if (!boxes.empty()) quickSort(boxes, 0, boxes.size() - 1);
+        } else if (stage == 2) {
+            // 输出和抑制标记复用帧内缓冲
+            nms(boxes, f->kept, f->suppressed, cfg.iouThreshold, cfg.maxOutput);
+        }
+    }
+
+    // 把帧送入第stage级。队列容量不小于帧池大小，入队总能成功；重试循环只是防御性的
+    void forward(PipelineFrame* f, int stage) {
+        BoundedQueue<PipelineFrame*>& q = stage < PIPELINE_STAGES ? *inbox[stage] : outbox;
+        f->enqueued = chrono::steady_clock::now();
+        while (!q.tryPush(f)) {
+            if (!pool.tryRunOne()) this_thread::yield();
+        }
+        if (stage == PIPELINE_STAGES) {
+            endToEnd.record(nanosSince(f->submitted));
+            return;
+        }
+        pool.spawn([this, stage]() { runStage(stage); });
+    }
+
+    // 任务数与入队数相等，因此总能取到一帧（生产者可能尚未发布完槽位，稍等即可）
+    void runStage(int stage) {
+        PipelineFrame* f;
+        while (!inbox[stage]->tryPop(f)) this_thread::yield();
+        waitHist[stage].record(nanosSince(f->enqueued));
+        auto start = chrono::steady_clock::now();
+        process(stage, f);
+        serviceHist[stage].record(nanosSince(start));
+        forward(f, stage + 1);
+    }
+
+public:
+    explicit NMSPipeline(const PipelineConfig& config)
+        : cfg(config), freeFrames(config.frames), outbox(config.frames), inFlight(0), pool(config.threads) {
+        for (int s = 0; s < PIPELINE_STAGES; s++) inbox.emplace_back(new BoundedQueue<PipelineFrame*>(cfg.frames));
+        for (int i = 0; i < cfg.frames; i++) {
+            storage.emplace_back(new PipelineFrame());
+            freeFrames.tryPush(storage.back().get());
+        }
+    }
+
+    // 从缓冲池取一帧，池空（在途帧已满）时返回nullptr，由调用方决定丢帧或稍后重试
+    PipelineFrame* acquire() {
+        PipelineFrame* f;
+        if (!freeFrames.tryPop(f)) return nullptr;
+        f->boxes.clear();
+        f->kept.clear();
+        return f;
+    }
+
+    void submit(PipelineFrame* f) {
+        inFlight++;
+        f->submitted = chrono::steady_clock::now();
+        forward(f, 0);
+    }
+
+    // 取一个已完成的帧，没有时返回nullptr；用完后需recycle
+    PipelineFrame* poll() {
+        PipelineFrame* f;
+        return outbox.tryPop(f) ? f : nullptr;
+    }
+
+    void recycle(PipelineFrame* f) {
+        inFlight--;
+        freeFrames.tryPush(f);
+    }
+
+    long inFlightCount() const { return inFlight.load(); }
+
+    // 各级排队/处理延迟与端到端延迟（p50/p99/max，微秒）
+    void report(ostream& os) const {
+        auto us = [](uint64_t ns) { return ns / 1000.0; };
+        os << fixed << setprecision(1);
+        os << setw(14) << "阶段" << setw(12) << "排队p50" << setw(12) << "排队p99" << setw(12) << "处理p50"
+           << setw(12) << "处理p99" << setw(12) << "处理max" << " (单位：us)" << endl;
+        for (int s = 0; s < PIPELINE_STAGES; s++) {
+            os << setw(14) << PIPELINE_STAGE_NAMES[s] << setw(12) << us(waitHist[s].percentile(50))
+               << setw(12) << us(waitHist[s].percentile(99)) << setw(12) << us(serviceHist[s].percentile(50))
+               << setw(12) << us(serviceHist[s].percentile(99)) << setw(12) << us(serviceHist[s].maximum()) << endl;
+        }
+        os << "端到端：" << endToEnd.count() << " 帧，p50 " << us(endToEnd.percentile(50)) << " us，p99 "
+           << us(endToEnd.percentile(99)) << " us，max " << us(endToEnd.maximum()) << " us" << endl;
+    }
+};
+
+// 按streams路×fps的节奏向流水线送帧（每帧boxesPerFrame个候选框），运行seconds秒，统计吞吐、丢帧与延迟
+void runPipelineBenchmark(int streams, int fps, double seconds, int threads, int boxesPerFrame) {
+    PipelineConfig cfg;
+    cfg.threads = threads;
+    cfg.frames = max(64, streams * 4);
+    NMSPipeline pipeline(cfg);
+
+    // 预先生成若干帧数据循环使用，送帧时复制进池化缓冲（模拟检测器输出）
+    vector<vector<BoundingBox>> inputs;
+    for (int i = 0; i < 8; i++) inputs.push_back(i % 2 == 0 ? generateRandomData(boxesPerFrame) : generateClusteredData(boxesPerFrame));
+
+    cout << "流水线：" << streams << " 路 × " << fps << " fps，每帧 " << boxesPerFrame << " 个候选框，"
+         << threads << " 个线程，运行 " << seconds << " 秒" << endl;
+    long long total = (long long)(streams * fps * seconds), submitted = 0, dropped = 0, done = 0;
+    vector<long long> nextSeq(streams, 0), lastSeq(streams, -1);
+    long long outOfOrder = 0;
+    auto drain = [&]() {
+        while (PipelineFrame* f = pipeline.poll()) {
+            if (f->seq < lastSeq[f->stream]) outOfOrder++;
+            lastSeq[f->stream] = max(lastSeq[f->stream], f->seq);
+            done++;
+            pipeline.recycle(f);
+        }
+    };
+    auto interval = chrono::duration<double>(1.0 / (streams * (double)fps));
+    auto start = chrono::steady_clock::now();
+    for (long long k = 0; k < total; k++) {
+        auto due = start + chrono::duration_cast<chrono::steady_clock::duration>(interval * (double)k);
+        while (chrono::steady_clock::now() < due) {
+            drain();
+            this_thread::yield();
+        }
+        int stream = k % streams;
+        PipelineFrame* f = pipeline.acquire();
+        if (!f) { // 在途帧已满：丢弃该帧，避免拖慢所有路
+            dropped++;
+            nextSeq[stream]++;
+            continue;
+        }
+        f->stream = stream;
+        f->seq = nextSeq[stream]++;
+        f->boxes.assign(inputs[k % inputs.size()].begin(), inputs[k % inputs.size()].end());
+        pipeline.submit(f);
+        submitted++;
+        drain();
+    }
+    while (pipeline.inFlightCount() > 0) {
+        drain();
+        this_thread::yield();
+    }
+    double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << fixed << setprecision(1) << "提交 " << submitted << " 帧，完成 " << done << " 帧，丢弃 " << dropped
+         << " 帧，吞吐 " << done / elapsed << " 帧/秒，路内乱序输出 " << outOfOrder << " 帧" << endl;
+    pipeline.report(cout);
+}
+
 // -------------------------- 性能测试模块 --------------------------
-// 测试单个排序算法的运行时间（返回毫秒数）
-double testSortPerformance(void (*sortFunc)(vector<BoundingBox>&), vector<BoundingBox> data) {
+// 测试单个排序算法的运行时间（返回毫秒数）；在计时之外复制一份数据排序，原数据不变
+double testSortPerformance(void (*sortFunc)(vector<BoundingBox>&), const vector<BoundingBox>& data) {
+    vector<BoundingBox> work = data;
     clock_t start = clock();
-    sortFunc(data); // 调用排序函数（传值避免修改原数据）
+    sortFunc(work);
     clock_t end = clock();
     return (double)(end - start) / CLOCKS_PER_SEC * 1000; // 转换为毫秒
 }
 
 // 测试归并排序（需左右边界参数）
-double testMergeSortPerformance(vector<BoundingBox> data) {
+double testMergeSortPerformance(const vector<BoundingBox>& data) {
+    vector<BoundingBox> work = data;
     clock_t start = clock();
-    mergeSort(data, 0, data.size() - 1);
+    mergeSort(work, 0, work.size() - 1);
     clock_t end = clock();
     return (double)(end - start) / CLOCKS_PER_SEC * 1000;
 }
 
 // 测试快速排序（需左右边界参数）
-double testQuickSortPerformance(vector<BoundingBox> data) {
+double testQuickSortPerformance(const vector<BoundingBox>& data) {
+    vector<BoundingBox> work = data;
     clock_t start = clock();
-    quickSort(data, 0, data.size() - 1);
+    quickSort(work, 0, work.size() - 1);
     clock_t end = clock();
     return (double)(end - start) / CLOCKS_PER_SEC * 1000;
 }
@@ -250,6 +1284,94 @@ void runExperiment() {
         }
     }
     
+    // 快速排序（内省排序）在退化输入上的表现，与归并排序对比
+    cout << "\n==================================== 退化输入下的排序 ====================================" << endl;
+    cout << setw(10) << "数据规模" << setw(14) << "输入形态" << setw(12) << sortNames[0] << setw(12) << sortNames[1] << " (单位：ms)" << endl;
+    const int bigSize = 1000000;
+    vector<string> shapes = {"随机", "已降序", "升序", "接近有序", "全部相同", "聚集分布"};
+    for (size_t shape = 0; shape < shapes.size(); shape++) {
+        vector<BoundingBox> data = shape == 5 ? generateClusteredData(bigSize) : generateRandomData(bigSize);
+        if (shape == 1 || shape == 2 || shape == 3) mergeSort(data, 0, data.size() - 1);
+        if (shape == 2) reverse(data.begin(), data.end());
+        if (shape == 3) {
+            datagen::Rng rng(datagen::nextSeed());
+            for (int k = 0; k < 100; k++) swap(data[rng.below(bigSize)], data[rng.below(bigSize)]);
+        }
+        if (shape == 4) {
+            for (BoundingBox& b : data) b.score = 1.0f;
+        }
+        double quickTime = testQuickSortPerformance(data);
+        double mergeTime = testMergeSortPerformance(data);
+        cout << setw(10) << bigSize << setw(14) << shapes[shape]
+             << setw(12) << fixed << setprecision(2) << quickTime
+             << setw(12) << fixed << setprecision(2) << mergeTime << endl;
+    }
+
+    // 基数排序与内省排序对比（多线程用墙钟时间，clock()会累加各线程的CPU时间）
+    int hw = max(1u, thread::hardware_concurrency());
+    cout << "\n==================================== 基数排序 ====================================" << endl;
+    cout << setw(10) << "数据规模" << setw(12) << "数据分布" << setw(12) << sortNames[0] << setw(12) << "基数排序"
+         << setw(16) << "基数排序(" + to_string(hw) + "线程)" << "  结果" << " (单位：ms)" << endl;
+    for (int size : {100000, 1000000, 4000000}) {
+        for (int distIdx = 0; distIdx < 2; distIdx++) {
+            vector<BoundingBox> data = distIdx == 0 ? generateRandomData(size) : generateClusteredData(size);
+            vector<BoundingBox> a = data, b = data, c = data;
+            auto t0 = chrono::steady_clock::now();
+            quickSort(a, 0, a.size() - 1);
+            auto t1 = chrono::steady_clock::now();
+            radixSort(b);
+            auto t2 = chrono::steady_clock::now();
+            radixSort(c, hw);
+            auto t3 = chrono::steady_clock::now();
+            // 基数排序稳定，与稳定排序的结果逐字节相同
+            stable_sort(data.begin(), data.end(), [](const BoundingBox& x, const BoundingBox& y) { return x.score > y.score; });
+            bool same = memcmp(b.data(), data.data(), size * sizeof(BoundingBox)) == 0 &&
+                        memcmp(c.data(), data.data(), size * sizeof(BoundingBox)) == 0;
+            for (int i = 0; same && i < size; i++) same = a[i].score == b[i].score;
+            cout << setw(10) << size << setw(12) << distributions[distIdx]
+                 << setw(12) << fixed << setprecision(2) << chrono::duration<double, milli>(t1 - t0).count()
+                 << setw(12) << fixed << setprecision(2) << chrono::duration<double, milli>(t2 - t1).count()
+                 << setw(16) << fixed << setprecision(2) << chrono::duration<double, milli>(t3 - t2).count()
+                 << "  " << (same ? "一致且稳定" : "不一致") << endl;
+        }
+    }
+
+    // 搬运整条记录的排序 vs 键-下标排序（排列只应用一次）
+    cout << "\n==================================== 键-下标排序 ====================================" << endl;
+    cout << setw(10) << "数据规模" << setw(14) << "快速排序" << setw(16) << "键-下标快排" << setw(16) << "键-下标基数"
+         << setw(14) << "其中重排" << "  结果" << " (单位：ms)" << endl;
+    for (int size : {10000, 100000, 1000000, 10000000}) {
+        vector<BoundingBox> data = generateRandomData(size);
+        double moveTime = testQuickSortPerformance(data);
+        double keyTime = testSortPerformance(keyIndexSort, data);
+
+        vector<BoundingBox> work = data;
+        clock_t t0 = clock();
+        vector<uint32_t> perm = radixSortIndices(work);
+        clock_t t1 = clock();
+        applyPermutation(work, perm);
+        clock_t t2 = clock();
+
+        vector<BoundingBox> check = data;
+        keyIndexSort(check);
+        bool same = true;
+        for (int i = 0; same && i < size; i++) same = check[i].score == work[i].score;
+        cout << setw(10) << size << setw(14) << fixed << setprecision(2) << moveTime
+             << setw(16) << fixed << setprecision(2) << keyTime
+             << setw(16) << fixed << setprecision(2) << (double)(t2 - t0) / CLOCKS_PER_SEC * 1000
+             << setw(14) << fixed << setprecision(2) << (double)(t2 - t1) / CLOCKS_PER_SEC * 1000
+             << "  " << (same ? "一致" : "不一致") << endl;
+    }
+    // 直接把排列交给NMS，边界框不重排
+    vector<BoundingBox> idxData = generateRandomData(10000);
+    vector<uint32_t> order = sortIndicesByScore(idxData);
+    vector<BoundingBox> idxSorted = idxData;
+    applyPermutation(idxSorted, order);
+    vector<BoundingBox> viaPerm = nmsIndexed(idxData, order), viaSorted = nms(idxSorted);
+    bool nmsSame = viaPerm.size() == viaSorted.size();
+    for (size_t i = 0; nmsSame && i < viaPerm.size(); i++) nmsSame = memcmp(&viaPerm[i], &viaSorted[i], sizeof(BoundingBox)) == 0;
+    cout << "按排列NMS：保留 " << viaPerm.size() << " 个，" << (nmsSame ? "与重排后NMS一致" : "与重排后NMS不一致") << endl;
+
     // 测试NMS算法（以10000个随机分布数据为例）
     cout << "\n==================================== NMS算法测试 ====================================" << endl;
     vector<BoundingBox> nmsData = generateRandomData(10000);
@@ -263,9 +1385,217 @@ void runExperiment() {
     cout << "NMS输入边界框数量：" << nmsData.size() << endl;
     cout << "NMS输出边界框数量：" << nmsResult.size() << endl;
     cout << "NMS算法运行时间：" << fixed << setprecision(2) << nmsTime << " ms" << endl;
+
+    // 网格加速NMS：与基础NMS对比耗时并校验结果一致
+    cout << "\n==================================== 网格加速NMS对比 ====================================" << endl;
+    cout << setw(10) << "数据规模" << setw(12) << "数据分布" << setw(12) << "基础NMS" << setw(12) << "网格NMS"
+         << setw(10) << "保留数" << "  结果" << " (单位：ms)" << endl;
+    for (int size : {10000, 50000, 200000}) {
+        for (int distIdx = 0; distIdx < 2; distIdx++) {
+            vector<BoundingBox> data = distIdx == 0 ? generateRandomData(size) : generateClusteredData(size);
+            quickSort(data, 0, data.size() - 1);
+
+            clock_t t0 = clock();
+            vector<BoundingBox> ref = nms(data);
+            clock_t t1 = clock();
+            vector<BoundingBox> fast = nmsGrid(data);
+            clock_t t2 = clock();
+
+            bool same = ref.size() == fast.size();
+            for (size_t i = 0; same && i < ref.size(); i++) {
+                same = ref[i].x1 == fast[i].x1 && ref[i].y1 == fast[i].y1 && ref[i].x2 == fast[i].x2 &&
+                       ref[i].y2 == fast[i].y2 && ref[i].score == fast[i].score;
+            }
+            cout << setw(10) << size << setw(12) << distributions[distIdx]
+                 << setw(12) << fixed << setprecision(2) << (double)(t1 - t0) / CLOCKS_PER_SEC * 1000
+                 << setw(12) << fixed << setprecision(2) << (double)(t2 - t1) / CLOCKS_PER_SEC * 1000
+                 << setw(10) << fast.size() << "  " << (same ? "一致" : "不一致") << endl;
+        }
+    }
+
+    // SoA + SIMD抑制内核（无除法比较），与基础NMS对比
+    cout << "\n==================================== SIMD NMS对比（" << simdLevel() << "） ====================================" << endl;
+    cout << setw(10) << "数据规模" << setw(12) << "数据分布" << setw(12) << "基础NMS" << setw(12) << "SIMD NMS"
+         << setw(10) << "保留数" << "  与基础NMS的差异" << " (单位：ms)" << endl;
+    for (int size : {10000, 50000}) {
+        for (int distIdx = 0; distIdx < 2; distIdx++) {
+            vector<BoundingBox> data = distIdx == 0 ? generateRandomData(size) : generateClusteredData(size);
+            quickSort(data, 0, data.size() - 1);
+            BoxBatch batch = BoxBatch::fromBoxes(data);
+
+            clock_t t0 = clock();
+            vector<BoundingBox> ref = nms(data);
+            clock_t t1 = clock();
+            vector<int> keep = nmsBatch(batch);
+            clock_t t2 = clock();
+
+            // 阈值舍入边界上的判定可能不同，统计保留集合的差异
+            size_t diff = ref.size() > keep.size() ? ref.size() - keep.size() : keep.size() - ref.size();
+            for (size_t i = 0; i < min(ref.size(), keep.size()); i++) {
+                if (ref[i].score != batch.score[keep[i]] || ref[i].x1 != batch.x1[keep[i]] || ref[i].y1 != batch.y1[keep[i]]) {
+                    diff = max(diff, (size_t)1);
+                    break;
+                }
+            }
+            cout << setw(10) << size << setw(12) << distributions[distIdx]
+                 << setw(12) << fixed << setprecision(2) << (double)(t1 - t0) / CLOCKS_PER_SEC * 1000
+                 << setw(12) << fixed << setprecision(2) << (double)(t2 - t1) / CLOCKS_PER_SEC * 1000
+                 << setw(10) << keep.size() << "  " << (diff == 0 ? "一致" : "存在舍入边界差异") << endl;
+        }
+    }
+    // Soft-NMS、Top-K提前结束与多类别批量NMS
+    cout << "\n==================================== Soft-NMS / Top-K / 批量NMS ====================================" << endl;
+    vector<BoundingBox> softData = generateRandomData(5000);
+    clock_t s0 = clock();
+    vector<BoundingBox> softLinear = softNMS(softData, SoftNMSMethod::Linear);
+    clock_t s1 = clock();
+    vector<BoundingBox> softGauss = softNMS(softData, SoftNMSMethod::Gaussian);
+    clock_t s2 = clock();
+    cout << "Soft-NMS（线性）：输入 " << softData.size() << "，输出 " << softLinear.size() << "，"
+         << fixed << setprecision(2) << (double)(s1 - s0) / CLOCKS_PER_SEC * 1000 << " ms" << endl;
+    cout << "Soft-NMS（高斯）：输入 " << softData.size() << "，输出 " << softGauss.size() << "，"
+         << fixed << setprecision(2) << (double)(s2 - s1) / CLOCKS_PER_SEC * 1000 << " ms" << endl;
+
+    vector<BoundingBox> topkData = generateRandomData(50000);
+    quickSort(topkData, 0, topkData.size() - 1);
+    clock_t k0 = clock();
+    vector<BoundingBox> full = nms(topkData);
+    clock_t k1 = clock();
+    vector<BoundingBox> top100 = nms(topkData, 0.5f, 100);
+    clock_t k2 = clock();
+    bool prefix = top100.size() == min(full.size(), (size_t)100);
+    for (size_t i = 0; prefix && i < top100.size(); i++) prefix = top100[i].score == full[i].score && top100[i].x1 == full[i].x1;
+    cout << "Top-100提前结束：完整NMS " << fixed << setprecision(2) << (double)(k1 - k0) / CLOCKS_PER_SEC * 1000
+         << " ms，Top-100 " << (double)(k2 - k1) / CLOCKS_PER_SEC * 1000 << " ms，"
+         << (prefix ? "与完整结果前100个一致" : "与完整结果不一致") << endl;
+
+    // 4张图像 × 80个类别，共200000个框
+    vector<BoundingBox> batchData = generateRandomData(200000);
+    vector<int> classIds(batchData.size()), imageIds(batchData.size());
+    datagen::Rng groupRng(datagen::nextSeed());
+    for (size_t i = 0; i < batchData.size(); i++) {
+        classIds[i] = groupRng.below(80);
+        imageIds[i] = groupRng.below(4);
+    }
+    int threads = max(1u, thread::hardware_concurrency());
+    auto w0 = chrono::steady_clock::now();
+    vector<int> serial = batchedNMS(batchData, classIds, imageIds, 0.5f, 0, 1);
+    auto w1 = chrono::steady_clock::now();
+    vector<int> parallel = batchedNMS(batchData, classIds, imageIds, 0.5f, 0, threads);
+    auto w2 = chrono::steady_clock::now();
+    cout << "批量NMS（4图×80类，" << batchData.size() << " 个框）：单线程 " << fixed << setprecision(2)
+         << chrono::duration<double, milli>(w1 - w0).count() << " ms，" << threads << " 线程 "
+         << chrono::duration<double, milli>(w2 - w1).count() << " ms，保留 " << parallel.size() << " 个，"
+         << (serial == parallel ? "结果一致" : "结果不一致") << endl;
+    // 预筛选 + Top-K选择 与 完整排序 对比（K=300，置信度阈值0.05）
+    cout << "\n==================================== 预筛选与Top-K选择 ====================================" << endl;
+    cout << setw(10) << "数据规模" << setw(12) << "数据分布" << setw(12) << "完整排序" << setw(12) << "Top-K选择"
+         << "  前K个置信度" << " (单位：ms)" << endl;
+    const int topK = 300;
+    const float minScore = 0.05f;
+    for (int size : {10000, 50000, 200000}) {
+        for (int distIdx = 0; distIdx < 2; distIdx++) {
+            vector<BoundingBox> data = distIdx == 0 ? generateRandomData(size) : generateClusteredData(size);
+
+            vector<BoundingBox> sorted = data;
+            clock_t t0 = clock();
+            quickSort(sorted, 0, sorted.size() - 1);
+            clock_t t1 = clock();
+            vector<BoundingBox> top = prefilterTopK(data, topK, minScore);
+            clock_t t2 = clock();
+
+            // 相同置信度的框可能互换，因此比较前K个的置信度序列
+            vector<BoundingBox> expect;
+            for (const BoundingBox& b : sorted) {
+                if ((int)expect.size() == topK) break;
+                if (b.score >= minScore) expect.push_back(b);
+            }
+            bool same = expect.size() == top.size();
+            for (size_t i = 0; same && i < top.size(); i++) same = expect[i].score == top[i].score;
+            cout << setw(10) << size << setw(12) << distributions[distIdx]
+                 << setw(12) << fixed << setprecision(2) << (double)(t1 - t0) / CLOCKS_PER_SEC * 1000
+                 << setw(12) << fixed << setprecision(2) << (double)(t2 - t1) / CLOCKS_PER_SEC * 1000
+                 << "  " << (same ? "一致" : "不一致") << endl;
+        }
+    }
+    // 多帧流式流水线（完整压测见 pipeline 子命令）
+    cout << "\n==================================== 多帧流式NMS流水线 ====================================" << endl;
+    runPipelineBenchmark(16, 60, 1.0, max(1u, thread::hardware_concurrency()), 20000);
+}
+
+// 在回放的数据集上测排序与NMS耗时，同一文件在不同构建间的结果可直接对比
+void runReplay(const vector<BoundingBox>& data) {
+    cout << "数据集：" << data.size() << " 个框" << endl;
+    cout << "快速排序: " << fixed << setprecision(2) << testQuickSortPerformance(data) << " ms" << endl;
+    cout << "归并排序: " << testMergeSortPerformance(data) << " ms" << endl;
+    cout << "基数排序: " << testSortPerformance([](vector<BoundingBox>& a) { radixSort(a); }, data) << " ms" << endl;
+
+    vector<BoundingBox> sorted = data;
+    radixSort(sorted);
+    auto timeNMS = [&](const char* name, vector<BoundingBox> (*fn)(const vector<BoundingBox>&, float)) {
+        clock_t t0 = clock();
+        size_t kept = fn(sorted, 0.5f).size();
+        clock_t t1 = clock();
+        cout << name << (double)(t1 - t0) / CLOCKS_PER_SEC * 1000 << " ms，保留 " << kept << " 个" << endl;
+    };
+    timeNMS("基础NMS: ", [](const vector<BoundingBox>& b, float t) { return nms(b, t); });
+    timeNMS("网格NMS: ", nmsGrid);
+    timeNMS("SIMD NMS: ", nmsSIMD);
 }
 
-int main() {
+// 用法：esp4                                               运行完整实验
+//       esp4 pipeline [路数=16] [fps=60] [秒数=2] [线程数] [每帧框数=20000]   流式NMS流水线压测
+//       esp4 dump <文件> <random|clustered> <框数> [种子]    生成数据集并保存
+//       esp4 replay <文件>                                   在保存的数据集上测排序与NMS
+// 数据默认由固定种子生成，可用环境变量 DATAGEN_SEED 更换
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "dump") {
+        if (argc < 5 || (string(argv[3]) != "random" && string(argv[3]) != "clustered") || atoi(argv[4]) < 0) {
+            cerr << "用法：esp4 dump <文件> <random|clustered> <框数> [种子]" << endl;
+            return 1;
+        }
+        uint64_t seed = argc > 5 ? strtoull(argv[5], nullptr, 0) : datagen::defaultSeed();
+        int size = atoi(argv[4]);
+        vector<BoundingBox> data = string(argv[3]) == "random" ? generateRandomData(size, seed) : generateClusteredData(size, seed);
+        try {
+            datagen::saveDataset(argv[2], data, seed);
+        } catch (const exception& e) {
+            cerr << e.what() << endl;
+            return 1;
+        }
+        cout << "已写入 " << data.size() << " 个框（种子 " << seed << "）到 " << argv[2] << endl;
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "replay") {
+        if (argc < 3) {
+            cerr << "用法：esp4 replay <文件>" << endl;
+            return 1;
+        }
+        vector<BoundingBox> data;
+        uint64_t seed = 0;
+        try {
+            data = datagen::loadDataset<BoundingBox>(argv[2], &seed);
+        } catch (const exception& e) {
+            cerr << e.what() << endl;
+            return 1;
+        }
+        cout << "回放 " << argv[2] << "（种子 " << seed << "）" << endl;
+        runReplay(data);
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "pipeline") {
+        int streams = argc > 2 ? atoi(argv[2]) : 16;
+        int fps = argc > 3 ? atoi(argv[3]) : 60;
+        double seconds = argc > 4 ? atof(argv[4]) : 2.0;
+        int threads = argc > 5 ? atoi(argv[5]) : max(1u, thread::hardware_concurrency());
+        int boxes = argc > 6 ? atoi(argv[6]) : 20000;
+        if (streams < 1 || fps < 1 || seconds <= 0 || threads < 1 || boxes < 0) {
+            cerr << "参数无效" << endl;
+            return 1;
+        }
+        runPipelineBenchmark(streams, fps, seconds, threads, boxes);
+        return 0;
+    }
     runExperiment();
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,404 @@
+// 热点路径埋点（单头文件）：作用域计时、按线程分片的无锁计数器、HDR式对数分桶延迟直方图
+// 编译时定义 PERFMON 才生效；未定义时所有宏展开为空，不引入任何开销
+//
+//   PERF_SCOPE("name")      作用域计时，析构时记入直方图
+//   PERF_SCOPE_TOP("name")  同上，递归函数只统计最外层调用
+//   PERF_COUNT("name", n)   计数器加n
+//
+// 计时默认用steady_clock（纳秒）；再定义 PERFMON_TSC 时在x86上改读TSC，导出时按steady_clock校准为纳秒
+// 导出：perfmon::exportTo(目标, 格式)，目标为文件路径或 tcp://主机:端口；格式为JSON或Prometheus文本
+// 设置环境变量 PERFMON_OUT 时程序退出前自动导出一次：扩展名为.prom或 PERFMON_FORMAT=prometheus 时
+// 输出Prometheus文本，否则输出JSON
+#ifndef PERFMON_H
+#define PERFMON_H
+
+#ifdef PERFMON
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#if defined(PERFMON_TSC) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#endif
+
+namespace perfmon {
+
+inline uint64_t steadyNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+inline uint64_t ticks() {
+#if defined(PERFMON_TSC) && (defined(__x86_64__) || defined(__i386__))
+    return __rdtsc();
+#else
+    return steadyNanos();
+#endif
+}
+
+// 对数分桶：每个2的幂区间再均分16格，相对误差不超过1/16，覆盖到2^64
+const int SUB_BUCKETS = 16;
+const int BUCKETS = 61 * SUB_BUCKETS;
+
+inline int bucketOf(uint64_t v) {
+    if (v < (uint64_t)SUB_BUCKETS) return (int)v;
+    int e = 63 - __builtin_clzll(v);
+    return (e - 3) * SUB_BUCKETS + (int)((v >> (e - 4)) & (SUB_BUCKETS - 1));
+}
+
+inline uint64_t bucketLow(int b) {
+    if (b < SUB_BUCKETS) return b;
+    int e = b / SUB_BUCKETS + 3;
+    return (uint64_t)(SUB_BUCKETS + b % SUB_BUCKETS) << (e - 4);
+}
+
+// 每个线程一个分片，独占缓存行；线程号超过MAX_THREADS时取模共用，原子加保证仍然正确
+const int MAX_THREADS = 128;
+
+struct alignas(64) Shard {
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> sum{0};
+    std::atomic<uint64_t> maxValue{0};
+    std::atomic<uint64_t> buckets[BUCKETS];
+
+    Shard() {
+        for (auto& b : buckets) b.store(0, std::memory_order_relaxed);
+    }
+};
+
+inline int threadSlot() {
+    static std::atomic<int> next(0);
+    thread_local int slot = next.fetch_add(1) % MAX_THREADS;
+    return slot;
+}
+
+enum class MetricKind { Counter, Timer };
+
+struct MetricSnapshot {
+    std::string name;
+    MetricKind kind;
+    uint64_t count;
+    double sum;  // 计时器为纳秒总和，计数器为累计值
+    double p50, p90, p99, p999, max;  // 纳秒，仅计时器
+};
+
+class Metric {
+private:
+    std::atomic<Shard*> shards[MAX_THREADS];
+
+    Shard& local() {
+        std::atomic<Shard*>& s = shards[threadSlot()];
+        Shard* p = s.load(std::memory_order_acquire);
+        if (p) return *p;
+        Shard* fresh = new Shard();
+        if (s.compare_exchange_strong(p, fresh, std::memory_order_acq_rel)) return *fresh;
+        delete fresh;
+        return *p;
+    }
+
+public:
+    const std::string name;
+    const MetricKind kind;
+
+    Metric(const std::string& n, MetricKind k) : name(n), kind(k) {
+        for (auto& s : shards) s.store(nullptr, std::memory_order_relaxed);
+    }
+    ~Metric() {
+        for (auto& s : shards) delete s.load();
+    }
+    Metric(const Metric&) = delete;
+    Metric& operator=(const Metric&) = delete;
+
+    void add(uint64_t delta) {
+        Shard& s = local();
+        s.count.fetch_add(1, std::memory_order_relaxed);
+        s.sum.fetch_add(delta, std::memory_order_relaxed);
+    }
+
+    void record(uint64_t t) {
+        Shard& s = local();
+        s.buckets[bucketOf(t)].fetch_add(1, std::memory_order_relaxed);
+        s.count.fetch_add(1, std::memory_order_relaxed);
+        s.sum.fetch_add(t, std::memory_order_relaxed);
+        uint64_t m = s.maxValue.load(std::memory_order_relaxed);
+        while (t > m && !s.maxValue.compare_exchange_weak(m, t, std::memory_order_relaxed)) {}
+    }
+
+    // 合并各线程分片；nsPerTick把计时单位换算为纳秒。与写入并发时各字段可能相差几次记录
+    MetricSnapshot snapshot(double nsPerTick) const {
+        MetricSnapshot r{name, kind, 0, 0, 0, 0, 0, 0, 0};
+        std::vector<uint64_t> merged(BUCKETS, 0);
+        uint64_t sum = 0, maxValue = 0, histCount = 0;
+        for (const auto& slot : shards) {
+            const Shard* s = slot.load(std::memory_order_acquire);
+            if (!s) continue;
+            r.count += s->count.load(std::memory_order_relaxed);
+            sum += s->sum.load(std::memory_order_relaxed);
+            maxValue = std::max(maxValue, s->maxValue.load(std::memory_order_relaxed));
+            for (int b = 0; b < BUCKETS; b++) {
+                uint64_t c = s->buckets[b].load(std::memory_order_relaxed);
+                merged[b] += c;
+                histCount += c;
+            }
+        }
+        if (kind == MetricKind::Counter) {
+            r.sum = (double)sum;
+            return r;
+        }
+        r.sum = sum * nsPerTick;
+        r.max = maxValue * nsPerTick;
+        // 第q分位取所在格的下界
+        auto quantile = [&](double q) {
+            if (histCount == 0) return 0.0;
+            uint64_t rank = std::max<uint64_t>(1, (uint64_t)std::ceil(q * histCount)), seen = 0;
+            for (int b = 0; b < BUCKETS; b++) {
+                seen += merged[b];
+                if (seen >= rank) return std::min(bucketLow(b), maxValue) * nsPerTick;
+            }
+            return maxValue * nsPerTick;
+        };
+        r.p50 = quantile(0.5);
+        r.p90 = quantile(0.9);
+        r.p99 = quantile(0.99);
+        r.p999 = quantile(0.999);
+        return r;
+    }
+};
+
+enum class Format { JSON, Prometheus };
+
+// 全局注册表：同名埋点共用一个指标；退出时按 PERFMON_OUT 自动导出
+class Registry {
+private:
+    std::mutex lock;
+    std::vector<std::unique_ptr<Metric>> metrics;
+    uint64_t startTicks, startNanos;
+
+    Registry() : startTicks(ticks()), startNanos(steadyNanos()) {}
+
+    Metric& get(const std::string& name, MetricKind kind) {
+        std::lock_guard<std::mutex> guard(lock);
+        for (auto& m : metrics) {
+            if (m->name != name) continue;
+            if (m->kind != kind) throw std::invalid_argument("指标类型冲突: " + name);
+            return *m;
+        }
+        metrics.emplace_back(new Metric(name, kind));
+        return *metrics.back();
+    }
+
+public:
+    static Registry& instance() {
+        static Registry registry;
+        return registry;
+    }
+
+    ~Registry();
+
+    Metric& timer(const std::string& name) { return get(name, MetricKind::Timer); }
+    Metric& counter(const std::string& name) { return get(name, MetricKind::Counter); }
+
+    // 计时单位与纳秒之比：steady_clock为1；TSC用启动以来的steady_clock区间校准（不足10ms时先补足）
+    double nsPerTick() {
+#if defined(PERFMON_TSC) && (defined(__x86_64__) || defined(__i386__))
+        uint64_t elapsed = steadyNanos() - startNanos;
+        if (elapsed < 10000000) std::this_thread::sleep_for(std::chrono::nanoseconds(10000000 - elapsed));
+        uint64_t t = ticks(), ns = steadyNanos();
+        return t > startTicks ? (double)(ns - startNanos) / (t - startTicks) : 1.0;
+#else
+        return 1.0;
+#endif
+    }
+
+    std::vector<MetricSnapshot> snapshot() {
+        double scale = nsPerTick();
+        std::lock_guard<std::mutex> guard(lock);
+        std::vector<MetricSnapshot> out;
+        for (auto& m : metrics) out.push_back(m->snapshot(scale));
+        return out;
+    }
+};
+
+// 作用域计时：depth非空时只有最外层（depth从0进入）的调用被记录
+class ScopedTimer {
+private:
+    Metric& metric;
+    int* depth;
+    uint64_t start;
+
+public:
+    // 内层调用不读时钟，递归函数的开销只剩一次深度加减
+    ScopedTimer(Metric& m, int* nesting = nullptr) : metric(m), depth(nesting), start(0) {
+        if (!depth || (*depth)++ == 0) start = ticks();
+    }
+    ~ScopedTimer() {
+        if (depth && --*depth > 0) return;
+        metric.record(ticks() - start);
+    }
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+};
+
+inline std::string formatNumber(double v) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.17g", v);
+    return buf;
+}
+
+inline std::string toJSON(const std::vector<MetricSnapshot>& metrics) {
+    std::ostringstream os;
+    os << "{\"metrics\":[";
+    for (size_t i = 0; i < metrics.size(); i++) {
+        const MetricSnapshot& m = metrics[i];
+        os << (i ? "," : "") << "{\"name\":\"" << m.name << "\",";
+        if (m.kind == MetricKind::Counter) {
+            os << "\"type\":\"counter\",\"updates\":" << m.count << ",\"value\":" << formatNumber(m.sum) << "}";
+        } else {
+            os << "\"type\":\"timer\",\"count\":" << m.count << ",\"sum_ns\":" << formatNumber(m.sum)
+               << ",\"p50_ns\":" << formatNumber(m.p50) << ",\"p90_ns\":" << formatNumber(m.p90)
+               << ",\"p99_ns\":" << formatNumber(m.p99) << ",\"p999_ns\":" << formatNumber(m.p999)
+               << ",\"max_ns\":" << formatNumber(m.max) << "}";
+        }
+    }
+    os << "]}\n";
+    return os.str();
+}
+
+// 计时器导出为summary（秒），计数器导出为counter（_total）
+inline std::string toPrometheus(const std::vector<MetricSnapshot>& metrics) {
+    std::ostringstream os;
+    for (const MetricSnapshot& m : metrics) {
+        if (m.kind == MetricKind::Counter) {
+            os << "# TYPE " << m.name << "_total counter\n" << m.name << "_total " << formatNumber(m.sum) << "\n";
+            continue;
+        }
+        std::string n = m.name + "_seconds";
+        os << "# TYPE " << n << " summary\n";
+        const double qs[] = {0.5, 0.9, 0.99, 0.999};
+        const double vs[] = {m.p50, m.p90, m.p99, m.p999};
+        for (int i = 0; i < 4; i++) {
+            os << n << "{quantile=\"" << qs[i] << "\"} " << formatNumber(vs[i] * 1e-9) << "\n";
+        }
+        os << n << "_sum " << formatNumber(m.sum * 1e-9) << "\n" << n << "_count " << m.count << "\n";
+    }
+    return os.str();
+}
+
+#ifdef MSG_NOSIGNAL
+const int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+const int SEND_FLAGS = 0;  // 没有MSG_NOSIGNAL的平台依赖SO_NOSIGPIPE
+#endif
+
+inline void sendTCP(const std::string& hostPort, const std::string& payload) {
+    size_t colon = hostPort.rfind(':');
+    if (colon == std::string::npos) throw std::invalid_argument("缺少端口: " + hostPort);
+    std::string host = hostPort.substr(0, colon), port = hostPort.substr(colon + 1);
+    addrinfo hints, *res = nullptr;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    if (getaddrinfo(host.c_str(), port.c_str(), &hints, &res) != 0) throw std::runtime_error("无法解析地址: " + hostPort);
+    int fd = -1;
+    for (addrinfo* a = res; a && fd < 0; a = a->ai_next) {
+        fd = socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+#ifdef SO_NOSIGPIPE
+        if (fd >= 0) {
+            int on = 1;
+            setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+        }
+#endif
+        if (fd >= 0 && connect(fd, a->ai_addr, a->ai_addrlen) != 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(res);
+    if (fd < 0) throw std::runtime_error("无法连接: " + hostPort);
+    for (size_t off = 0; off < payload.size();) {
+        // 对端已关闭时不能收到SIGPIPE（导出常在退出时执行），改为返回错误走异常路径
+        ssize_t w = send(fd, payload.data() + off, payload.size() - off, SEND_FLAGS);
+        if (w <= 0) {
+            close(fd);
+            throw std::runtime_error("发送失败: " + hostPort);
+        }
+        off += w;
+    }
+    close(fd);
+}
+
+// 写出快照：target为文件路径或 tcp://主机:端口
+inline void writeSnapshot(const std::vector<MetricSnapshot>& metrics, const std::string& target, Format format) {
+    std::string payload = format == Format::JSON ? toJSON(metrics) : toPrometheus(metrics);
+    if (target.compare(0, 6, "tcp://") == 0) {
+        sendTCP(target.substr(6), payload);
+        return;
+    }
+    std::ofstream out(target);
+    if (!out) throw std::runtime_error("无法写入: " + target);
+    out << payload;
+}
+
+inline void exportTo(const std::string& target, Format format) {
+    writeSnapshot(Registry::instance().snapshot(), target, format);
+}
+
+inline Registry::~Registry() {
+    const char* target = getenv("PERFMON_OUT");
+    if (!target) return;
+    const char* fmt = getenv("PERFMON_FORMAT");
+    std::string t = target;
+    bool prom = fmt ? std::string(fmt) == "prometheus" : t.size() >= 5 && t.compare(t.size() - 5, 5, ".prom") == 0;
+    try {
+        writeSnapshot(snapshot(), t, prom ? Format::Prometheus : Format::JSON);
+    } catch (const std::exception& e) {
+        fprintf(stderr, "perfmon: %s\n", e.what());
+    }
+}
+
+}  // namespace perfmon
+
+#define PERFMON_CAT2(a, b) a##b
+#define PERFMON_CAT(a, b) PERFMON_CAT2(a, b)
+
+#define PERF_SCOPE(name)                                                                                  \
+    static perfmon::Metric& PERFMON_CAT(perfMetric_, __LINE__) = perfmon::Registry::instance().timer(name); \
+    perfmon::ScopedTimer PERFMON_CAT(perfTimer_, __LINE__)(PERFMON_CAT(perfMetric_, __LINE__))
+
+#define PERF_SCOPE_TOP(name)                                                                              \
+    static perfmon::Metric& PERFMON_CAT(perfMetric_, __LINE__) = perfmon::Registry::instance().timer(name); \
+    static thread_local int PERFMON_CAT(perfDepth_, __LINE__) = 0;                                        \
+    perfmon::ScopedTimer PERFMON_CAT(perfTimer_, __LINE__)(PERFMON_CAT(perfMetric_, __LINE__),            \
+                                                           &PERFMON_CAT(perfDepth_, __LINE__))
+
+#define PERF_COUNT(name, delta)                                                                                 \
+    do {                                                                                                        \
+        static perfmon::Metric& perfCounter_ = perfmon::Registry::instance().counter(name);                    \
+        perfCounter_.add(delta);                                                                                \
+    } while (0)
+
+#else
+
+#define PERF_SCOPE(name) ((void)0)
+#define PERF_SCOPE_TOP(name) ((void)0)
+#define PERF_COUNT(name, delta) ((void)0)
+
+#endif
+
+#endif